@@ -0,0 +1,58 @@
+/*                  B U L K P R O P E R T I E S . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file BulkProperties.h */
+
+#ifndef RT3_BULKPROPERTIES_H
+#define RT3_BULKPROPERTIES_H
+
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QPushButton>
+#include "QVBoxWidget.h"
+#include "DataRow.h"
+
+class Document;
+
+/*
+ * Properties panel for several selected objects. Each change is made to all of them and applied with
+ * Document::modifyObjects, so it is one undo step, one pass over the tree and one repaint.
+ *
+ * Colors are set on the selected combinations. Moves change the matrix of each selected object in its parent
+ * combination, so every parent is copied and written once even when several of its children are selected.
+ */
+class BulkProperties : public QVBoxWidget {
+public:
+    explicit BulkProperties(Document &document);
+    void bindObjects(const QVector<int> &objectIds);
+
+private:
+    Document &document;
+    QVector<int> objectIds;
+
+    QLabel *countWidget;
+    QPushButton *colorButton;
+    DataRow *translationRow;
+    QPushButton *moveButton;
+
+    void setColor();
+    void move();
+};
+
+
+#endif //RT3_BULKPROPERTIES_H
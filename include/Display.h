@@ -26,6 +26,9 @@
 #include <include/Globals.h>
 
 #include <QtWidgets/QOpenGLWidget>
+#include <QOpenGLFramebufferObject>
+#include <QElapsedTimer>
+#include <QTimer>
 #include "AxesRenderer.h"
 #include <QMouseEvent>
 #include <include/GridRenderer.h>
@@ -40,6 +43,7 @@ class DisplayManager;
 class GeometryRenderer;
 class OrthographicCamera;
 class GridRenderer;
+class TransformGizmo;
 
 
 class Display : public QOpenGLWidget{
@@ -49,12 +53,14 @@ public:
     virtual ~Display();
 
     void forceRerenderFrame();
+    int pickObject(int x, int y);
 
     int getW() const;
     int getH() const;
     const Document* getDocument() const;
 	OrthographicCamera* getCamera() const;
 	DisplayManager* getDisplayManager() const;
+    TransformGizmo* getTransformGizmo() const;
 	bool gridEnabled = false;
 
 protected:
@@ -66,6 +72,7 @@ protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
     void keyPressEvent(QKeyEvent *k) override ;
+    void showEvent(QShowEvent *event) override;
 
 private:
     Document * document;
@@ -73,10 +80,29 @@ private:
     int h = 400;
     int prevMouseX = -1;
     int prevMouseY = -1;
+    int pressMouseX = -1;
+    int pressMouseY = -1;
+    const int clickMaxMouseMovement = 3;
     bool skipNextMouseMoveEvent = false;
     float keyPressSimulatedMouseMoveDistance = 8;
     QColor bgColor;
 
+    bool frameRequested = false;    // forceRerenderFrame was called after the last paintGL
+    bool frameInFlight = false;     // paintGL ran but the frame has not been swapped yet
+    QElapsedTimer frameTimer;       // time since the last paintGL
+    const int frameSwapTimeout = 100;
+
+    // Interactive quality is used while the camera moves: small solids are culled to keep the frame rate up
+    bool interacting = false;
+    QTimer interactionEndTimer;
+    const int interactionEndDelay = 150;
+    const int targetInteractiveFrameTime = 16;
+    float interactiveMinimumObjectPixels = 2;
+    const float minInteractiveMinimumObjectPixels = 2;
+    const float maxInteractiveMinimumObjectPixels = 64;
+    void startInteraction();
+    void adaptInteractiveQuality(qint64 frameTime);
+
     Qt::MouseButton rotateCameraMouseButton = Qt::LeftButton;
     Qt::MouseButton moveCameraMouseButton = Qt::RightButton;
     Qt::KeyboardModifier rotateAroundThirdAxisModifier = Qt::ShiftModifier;
@@ -85,6 +111,16 @@ private:
     DisplayManager *displayManager;
     AxesRenderer * axesRenderer;
 	GridRenderer * gridRenderer;
+    TransformGizmo * transformGizmo;
+
+    // Offscreen buffer where each visible solid is drawn in a flat color that encodes its objectId.
+    // It is only rendered when a pick is requested after the frame has changed.
+    QOpenGLFramebufferObject *idBuffer = nullptr;
+    bool idBufferUpToDate = false;
+    const int idBufferLineWidth = 3;
+    const int pickRadius = 3;
+    void renderIdBuffer();
+    void hoverObject(int x, int y);
 };
 
 
@@ -26,8 +26,14 @@
 #include <Windows.h>
 #endif
 
+#include <QHash>
+#include <QStack>
+#include <QMatrix4x4>
+#include <QOpenGLBuffer>
+#include <QOpenGLShaderProgram>
 #include "Display.h"
 #include "VectorList.h"
+#include "Utils.h"
 class Display;
 
 class DisplayManager{
@@ -36,6 +42,9 @@ public:
 
     // most of the methods below correspond to a method with a similar name from libdm
     void drawVList(BRLCAD::VectorList *vp);
+    void drawMesh(const TriangleMesh &mesh);
+    void drawMesh(const float *vertices, int vertexCount, const unsigned int *indices, int indexCount);
+    void drawLines(const float *points, int pointCount);
     void setFGColor(float r, float g, float b, float transparency);
     void setBGColor(float r, float g, float b);
     void setLineAttr(int width, int style);
@@ -52,6 +61,14 @@ public:
     void drawBegin();
     void loadMatrix(const GLfloat *m);
     void loadPMatrix(const GLfloat *m);
+    // Multiplies the model view matrix by model until popModelMatrix. Used to move geometry without re-plotting it.
+    void pushModelMatrix(const QMatrix4x4 &model);
+    void popModelMatrix();
+    void setLightingEnabled(bool enabled);
+    void setDepthTestEnabled(bool enabled);
+    void setFlatColor(float r, float g, float b);
+    void setIdColor(unsigned int objectId);
+    static unsigned int idFromColor(const unsigned char *rgba);
 
     class DrawVListElementCallback : public BRLCAD::VectorList::ElementCallback {
     public:
@@ -65,9 +82,72 @@ public:
         bool operator()(BRLCAD::VectorList::Element* element) override ;
     };
 
+    /*
+     * Vertices of a vector list in the form used by the shader path. Line strips are split into segments and
+     * polygons into triangles, so a whole vector list is drawn with at most one draw call per primitive type.
+     */
+    struct Batch {
+        enum Primitive {Lines, Triangles, Points, PrimitiveCount};
+
+        QVector<float> vertices[PrimitiveCount];    // position and normal of each vertex (6 floats) until uploaded
+        QOpenGLBuffer buffer;
+        int first[PrimitiveCount] = {0, 0, 0};      // offsets of the primitives in buffer, in vertices
+        int count[PrimitiveCount] = {0, 0, 0};
+        float color[4] = {0, 0, 0, 1};
+        float lineWidth = 0;                        // 0 if the vector list did not set one
+        float pointSize = 0;
+
+        // indexed triangles from drawMesh, drawn shaded. They are uploaded right away.
+        QOpenGLBuffer meshBuffer;
+        QOpenGLBuffer indexBuffer = QOpenGLBuffer(QOpenGLBuffer::IndexBuffer);
+        int indexCount = 0;
+    };
+
+    class BatchVListElementCallback : public BRLCAD::VectorList::ElementCallback {
+    public:
+        explicit BatchVListElementCallback(Batch *batch);
+        bool operator()(BRLCAD::VectorList::Element* element) override ;
+
+    private:
+        Batch *batch;
+        bool hasLinePoint = false;
+        double linePoint[3];
+        double normal[3] = {0, 0, 0};
+        QVector<double> polygon;     // points of the polygon being read
+
+        void addVertex(Batch::Primitive primitive, const double *point, const double *normal);
+    };
+
 private:
     Display &display;
 
+    // state of the shader path. It is shared by all displays like their (shared) OpenGL contexts
+    struct ShaderState {
+        bool lightingEnabled = true;
+        float flatColor[4] = {1, 1, 1, 1};
+        float lineWidth = 1;
+        float pointSize = 1;
+    };
+    static bool shadersInitialized;
+    static QOpenGLShaderProgram *program;           // nullptr if shaders are not available
+    static QHash<unsigned int, Batch *> batches;    // batches stand in for display lists in the shader path
+    static unsigned int nextBatchId;
+    static Batch *recordingBatch;
+    static ShaderState shaderState;
+    static QStack<ShaderState> savedShaderStates;
+    static QMatrix4x4 modelViewMatrix;
+    static QStack<QMatrix4x4> savedModelViewMatrices;
+    static QMatrix4x4 projectionMatrix;
+    static int modelViewMatrixLocation;
+    static int projectionMatrixLocation;
+    static int colorLocation;
+    static int shadedLocation;
+
+    static bool useShaders();
+    static void uploadBatch(Batch *batch);
+    static void uploadMesh(Batch *batch, const float *vertices, int vertexCount, const unsigned int *indices, int indexCount);
+    static void drawBatch(Batch *batch);
+
     int dmLight = 1;
     bool dmTransparency = false;
 
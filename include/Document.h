@@ -11,7 +11,18 @@
 #include "Properties.h"
 #include "GeometryRenderer.h"
 #include "DisplayGrid.h"
+#include "RayPicker.h"
+#include "Tessellator.h"
+#include "EditJournal.h"
+#include "ObjectEditCommand.h"
+#include <memory>
+#include <QUndoStack>
+#include <QCache>
+#include <QTimer>
+#include <QMatrix4x4>
+#include <brlcad/FileDatabase.h>
 #include <include/RaytraceView.h>
+#include "EditableDatabaseLoader.h"
 
 class Properties;
 class Display;
@@ -19,24 +30,90 @@ class GeometryRenderer;
 class DisplayGrid;
 class RaytraceView;
 class ObjectTreeWidget;
+class RayPicker;
+class Tessellator;
+class EditJournal;
 
 class Document {
 private:
     QString *filePath = nullptr;
-    BRLCAD::MemoryDatabase *database;
+    BRLCAD::ConstDatabase *database;              // either memoryDatabase or fileDatabase
+    BRLCAD::MemoryDatabase *memoryDatabase = nullptr;
+    BRLCAD::FileDatabase *fileDatabase = nullptr;
     DisplayGrid *displayGrid;
     ObjectTreeWidget *objectTreeWidget;
+    QWidget *objectTreePanel;   // objectTreeWidget under a search box
     Properties *properties;
     const int documentId;
     ObjectTree* objectTree;
     GeometryRenderer * geometryRenderer;
-
+    RayPicker * rayPicker;
+    Tessellator * tessellator;
+    EditJournal * journal;
+    QUndoStack * undoStack;
+    // Property edit shown by GeometryRenderer but not yet applied to the database. Owned by the properties panel.
+    BRLCAD::Object * previewedObject = nullptr;
+    QTimer previewCommitTimer;
+    // A parameter is being dragged. The preview is applied on release instead of after a pause.
+    bool interactiveEdit = false;
+    // Objects read through getObjectState or edited through modifyObject, by name. Shared with the undo stack.
+    // The states are never changed: an edit stores a new state, and modifyObjectNoSet drops the cached one.
+    // Only the most recently used ones are kept; an evicted state is read again from the database when needed.
+    QCache<QString, std::shared_ptr<const BRLCAD::Object>> objectStates{objectStateCacheSize};
+    bool loading = false;
+    bool saving = false;
+    // Names of the objects changed since the last save. DocumentSaver writes only these.
+    QSet<QString> modifiedObjectNames;
+    // While a mapped document is read into memory for editing, edits wait here and are applied when it is done
+    std::shared_ptr<EditableDatabaseLoader::Result> editableDatabaseLoad;
+    QVector<std::shared_ptr<const BRLCAD::Object>> pendingAddedObjects;
+    QVector<std::shared_ptr<const BRLCAD::Object>> pendingObjectStates;
+
+    void loadEditableDatabase();
+    void editableDatabaseLoaded();
+
+    void initialize(BRLCAD::ConstDatabase *database, bool buildObjectTree);
 
 public:
     explicit Document(int documentId, const QString *filePath = nullptr);
+    // Takes an already opened database. The object tree starts empty and DocumentLoader fills it in.
+    Document(int documentId, const QString *filePath, BRLCAD::ConstDatabase *database);
     virtual ~Document();
 
+    static const int undoLimit = 200;
+    static const int previewCommitDelay = 400; // ms
+    // Number of object states kept by getObjectState
+    static const int objectStateCacheSize = 256;
+
+    // Files larger than this are opened mapped and read only until the first edit. The first edit reads the whole
+    // file into memory on a worker thread, and the document takes no input until that is done: a mapped file
+    // is only loaded on demand for as long as it is viewed.
+    static const qint64 mappedLoadingThreshold = 64 * 1024 * 1024;
+
+    // Returns nullptr on failure. Safe to call from a worker thread.
+    static BRLCAD::ConstDatabase* openDatabase(const QString& filePath);
+
+    // Applies newObject as an undoable edit. newObject stays with the caller.
     void modifyObject(BRLCAD::Object* newObject);
+    // Applies all of newObjects as one undoable edit, with one pass over the tree and one repaint
+    void modifyObjects(const QVector<BRLCAD::Object*>& newObjects);
+    void applyObjectStates(const QVector<std::shared_ptr<const BRLCAD::Object>>& states);
+    // Shows newObject right away and applies it with modifyObject once edits pause for previewCommitDelay.
+    // newObject must stay valid until commitPreview, which the properties panel calls before rebinding.
+    void previewObject(BRLCAD::Object* newObject);
+    void commitPreview();
+    // Turning it off applies the preview
+    void setInteractiveEdit(bool interactiveEdit);
+    // Current state of an object, read from the database only the first time. nullptr if there is no such object.
+    // To edit it, Clone the state and give the copy to modifyObject.
+    std::shared_ptr<const BRLCAD::Object> getObjectState(const QString& objectName);
+    // Matrix of objectId in its parent combination. Identity for top objects and leaves without a matrix.
+    QMatrix4x4 getInstanceMatrix(int objectId);
+    // Product of the instance matrices from the top object down to objectId. Maps objectId's coordinates to world.
+    QMatrix4x4 getPathMatrix(int objectId);
+    // Sets the matrix of objectId in its parent combination as an undoable edit
+    void setInstanceMatrix(int objectId, const QMatrix4x4& matrix);
+    bool addObject(const BRLCAD::Object& object);
 
     RaytraceView * raytraceWidget;
     // getters setters
@@ -49,11 +126,43 @@ public:
     {
         return raytraceWidget;
     }
-    BRLCAD::MemoryDatabase* getDatabase() const
+    BRLCAD::ConstDatabase* getDatabase() const
     {
         return database;
     }
 
+    // Use this for anything that changes the database. For a mapped database the first call starts reading the file
+    // into memory and nullptr is returned until that is done. addObject and applyObjectStates keep their edits until then.
+    BRLCAD::MemoryDatabase* getWritableDatabase();
+
+    bool isMapped() const
+    {
+        return memoryDatabase == nullptr;
+    }
+
+    // While loading, a worker thread reads the database, so the document does not take input
+    bool isLoading() const
+    {
+        return loading;
+    }
+
+    void setLoading(bool loading);
+
+    bool isSaving() const
+    {
+        return saving;
+    }
+
+    void setSaving(bool saving)
+    {
+        this->saving = saving;
+    }
+
+    QSet<QString>& getModifiedObjectNames()
+    {
+        return modifiedObjectNames;
+    }
+
     Display* getDisplay();
 
     ObjectTreeWidget* getObjectTreeWidget() const
@@ -61,6 +170,11 @@ public:
 	    return objectTreeWidget;
     }
 
+    QWidget* getObjectTreePanel() const
+    {
+        return objectTreePanel;
+    }
+
     Properties* getProperties() const
     {
 	    return properties;
@@ -83,6 +197,22 @@ public:
         return geometryRenderer;
     }
 
+    RayPicker *getRayPicker() const {
+        return rayPicker;
+    }
+
+    Tessellator *getTessellator() const {
+        return tessellator;
+    }
+
+    EditJournal *getJournal() const {
+        return journal;
+    }
+
+    QUndoStack *getUndoStack() const {
+        return undoStack;
+    }
+
     void setFilePath(const QString& filePath)
     {
         this->filePath = new QString(filePath);
@@ -0,0 +1,69 @@
+/*                  D O C U M E N T L O A D E R . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file DocumentLoader.h */
+
+#ifndef RT3_DOCUMENTLOADER_H
+#define RT3_DOCUMENTLOADER_H
+
+#include <atomic>
+#include <QObject>
+#include <QString>
+#include <brlcad/ConstDatabase.h>
+#include "ObjectTree.h"
+
+/*
+ * Opens a database and reads its object tree on a worker thread.
+ *
+ * opened is emitted as soon as the database is open and its top objects are known, so the document can be shown.
+ * Then the subtree of each top object is sent with fragmentLoaded to be added to the document's ObjectTree on
+ * the GUI thread. The GUI thread must not use the database until finished is emitted.
+ *
+ * The loader and its thread delete themselves on the GUI thread after the receivers of finished ran.
+ */
+class DocumentLoader : public QObject {
+    Q_OBJECT
+public:
+    explicit DocumentLoader(const QString &filePath);
+
+    void start();
+    // Returns once the worker thread is done, ex: after cancel when the application is closed
+    void wait();
+    // Stops after the current top object. The database is deleted if it was not handed over with opened.
+    void cancel();
+
+    const QString &getFilePath() const {
+        return filePath;
+    }
+
+signals:
+    void opened(BRLCAD::ConstDatabase *database, int topObjectCount);
+    void fragmentLoaded(ObjectTree::Fragment *fragment); // the receiver takes the ownership of fragment
+    void failed();
+    void finished(bool canceled);
+
+private:
+    const QString filePath;
+    std::atomic<bool> canceled;
+
+    void load();
+};
+
+
+#endif //RT3_DOCUMENTLOADER_H
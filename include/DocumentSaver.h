@@ -0,0 +1,66 @@
+/*                   D O C U M E N T S A V E R . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file DocumentSaver.h */
+
+#ifndef RT3_DOCUMENTSAVER_H
+#define RT3_DOCUMENTSAVER_H
+
+#include <vector>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <brlcad/Object.h>
+
+class Document;
+
+/*
+ * Saves a document on a worker thread.
+ *
+ * The constructor takes a snapshot on the GUI thread: copies of the objects modified since the last save.
+ * The worker copies the file the document was last loaded from or saved to next to the target, writes only
+ * the modified objects into the copy (.g files are updated object by object in place) and renames it over
+ * the target. The target is either the old file or the new one, never a partly written file.
+ *
+ * The saver and its thread delete themselves after finished.
+ */
+class DocumentSaver : public QObject {
+    Q_OBJECT
+public:
+    DocumentSaver(Document *document, const QString &filePath);
+    ~DocumentSaver() override;
+
+    void start();
+
+signals:
+    // objectNames are the modified objects in the snapshot. They are still unsaved if success is false.
+    void finished(bool success, const QStringList &objectNames);
+
+private:
+    const QString filePath;
+    QString baseFilePath;
+    QStringList objectNames;
+    std::vector<BRLCAD::Object *> objects;
+
+    void save();
+    bool write(const QString &temporaryFilePath);
+};
+
+
+#endif //RT3_DOCUMENTSAVER_H
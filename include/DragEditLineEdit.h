@@ -6,18 +6,27 @@
 #include <QtWidgets/QLineEdit>
 #include <QMouseEvent>
 
+// Line edit whose value can also be changed by dragging the mouse up or down on it
 class DragEditLineEdit : public QLineEdit {
+    Q_OBJECT
 public:
     explicit DragEditLineEdit(const QString &string, QWidget *parent = nullptr);
     explicit DragEditLineEdit(QWidget *parent = nullptr);
 
+signals:
+    // Emitted when the cursor first moves past initialTolerance and when the button is released after that.
+    // The textEdited signals in between are the live values of the drag.
+    void dragStarted();
+    void dragFinished();
+
 protected:
     void mousePressEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
 
 private:
-    int initialY;
+    int initialY = -1;
+    bool dragging = false;
     int lastEmittedGlobalY;
     double map(int cursorValue);
     const int initialTolerance = 20;
@@ -0,0 +1,117 @@
+/*                     E D I T J O U R N A L . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file EditJournal.h */
+
+#ifndef RT3_EDITJOURNAL_H
+#define RT3_EDITJOURNAL_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QVector>
+#include <QTimer>
+#include <QThread>
+#include <QFile>
+#include <QLockFile>
+#include <brlcad/Object.h>
+#include <brlcad/FileDatabase.h>
+
+class Document;
+
+/*
+ * Writes the journal files on the journal's thread. Used only by EditJournal.
+ */
+class EditJournalWriter : public QObject {
+    Q_OBJECT
+public:
+    explicit EditJournalWriter(const QString &directory);
+    ~EditJournalWriter() override;
+
+public slots:
+    // Takes the ownership of objects
+    void write(const QVector<BRLCAD::Object *> &objects);
+    void writeBaseFilePath(const QString &baseFilePath);
+    void reset(const QString &baseFilePath);
+
+private:
+    const QString directory;
+    BRLCAD::FileDatabase *database = nullptr;
+    QFile log;
+
+    bool open();
+    void close();
+};
+
+/*
+ * Crash recovery journal of a document's unsaved edits.
+ *
+ * Each document has a directory under the user's data directory with
+ *  - journal.g: a database holding the latest state of every edited object (librt does the serialization)
+ *  - journal.log: an append only list of lines, "file <path>" for the file the edits apply to
+ *    and "object <name>" for each edited object, in the order of the edits
+ *  - journal.lock: held while the document is open
+ *
+ * record only marks the object. The marked objects are copied and handed to the writer thread together after
+ * commitInterval (group commit), so an edit costs a hash insert on the GUI thread.
+ *
+ * The directory is removed when the document is closed. If the application crashes it stays behind and its lock
+ * goes stale; MainWindow finds it with orphanedJournals on the next start and replays it.
+ */
+class EditJournal : public QObject {
+    Q_OBJECT
+public:
+    EditJournal(Document *document, const QString *baseFilePath);
+    ~EditJournal() override;
+
+    void record(const QString &objectName);
+    // Called after the document is saved to baseFilePath. The journal is emptied if nothing changed since.
+    void saved(const QString &baseFilePath, bool hasUnsavedEdits);
+
+    // Journals left behind by a crashed arbalest
+    static QStringList orphanedJournals();
+    // objectNames are the edited objects in the order of their first edit
+    static bool read(const QString &directory, QString &baseFilePath, QStringList &objectNames);
+    // Applies the edits in directory to document, which should be opened from the journal's base file
+    static bool replay(const QString &directory, Document *document);
+    static void remove(const QString &directory);
+
+signals:
+    void writeRequested(const QVector<BRLCAD::Object *> &objects);
+    void baseFilePathChanged(const QString &baseFilePath);
+    void resetRequested(const QString &baseFilePath);
+
+private:
+    const int commitInterval = 200; // ms
+
+    Document *document;
+    QString directory;
+    QLockFile *lock = nullptr;
+    QSet<QString> pendingObjectNames;
+    QTimer commitTimer;
+    QThread writerThread;
+
+    void commit();
+
+    static QString journalsDirectory();
+};
+
+
+#endif //RT3_EDITJOURNAL_H
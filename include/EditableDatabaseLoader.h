@@ -0,0 +1,66 @@
+/*       E D I T A B L E D A T A B A S E L O A D E R . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file EditableDatabaseLoader.h */
+
+#ifndef RT3_EDITABLEDATABASELOADER_H
+#define RT3_EDITABLEDATABASELOADER_H
+
+#include <memory>
+#include <QObject>
+#include <QString>
+#include <brlcad/MemoryDatabase.h>
+
+/*
+ * Reads the file of a mapped document into a MemoryDatabase on a worker thread, so that the document can be
+ * edited without the GUI thread waiting for the whole file.
+ *
+ * The database is handed over through a Result shared with the document. If the document is closed before it
+ * takes the database, the last owner of the Result deletes it.
+ *
+ * The loader and its thread delete themselves after finished.
+ */
+class EditableDatabaseLoader : public QObject {
+    Q_OBJECT
+public:
+    struct Result {
+        BRLCAD::MemoryDatabase *database = nullptr; // set before finished is emitted. nullptr if the file failed to load
+        ~Result();
+    };
+
+    explicit EditableDatabaseLoader(const QString &filePath);
+
+    void start();
+
+    const std::shared_ptr<Result> &getResult() const {
+        return result;
+    }
+
+signals:
+    void finished();
+
+private:
+    const QString filePath;
+    std::shared_ptr<Result> result;
+
+    void load();
+};
+
+
+#endif //RT3_EDITABLEDATABASELOADER_H
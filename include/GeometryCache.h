@@ -0,0 +1,85 @@
+/*                  G E O M E T R Y C A C H E . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file GeometryCache.h */
+
+#ifndef RT3_GEOMETRYCACHE_H
+#define RT3_GEOMETRYCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+
+/*
+ * Persistent cache of plotted wireframes and tessellated meshes under the user's cache directory.
+ *
+ * Entries are content addressed: the key is a hash of the object's name, its serialized form in the .g file,
+ * the matrix of its path, the display mode and the tolerances (see Tessellator::cacheKey). An entry is a small
+ * header followed by the raw vertex and index arrays, so it can be memory mapped and handed to OpenGL as is.
+ *
+ * The cache is bounded by maximumSize. Loading an entry refreshes its modification time, and when a store takes
+ * the cache over the bound the entries used least recently are deleted.
+ */
+class GeometryCache {
+public:
+    // A mapped cache entry. The pointers are valid as long as the entry exists.
+    class Entry {
+    public:
+        const float *vertices = nullptr;
+        unsigned int floatsPerVertex = 0;   // 3 for wireframes (pairs of vertices are line segments), 6 for meshes
+        unsigned int vertexCount = 0;
+        const unsigned int *indices = nullptr;
+        unsigned int indexCount = 0;
+
+    private:
+        friend class GeometryCache;
+        QFile file;
+    };
+
+    // Bytes of entries kept on disk
+    static const qint64 maximumSize = 2LL * 1024 * 1024 * 1024;
+
+    GeometryCache();
+
+    bool load(const QByteArray &key, Entry &entry);
+    void store(const QByteArray &key, const float *vertices, unsigned int floatsPerVertex, unsigned int vertexCount,
+               const unsigned int *indices, unsigned int indexCount);
+
+private:
+    struct Header {
+        char magic[8];
+        quint32 version;
+        quint32 floatsPerVertex;
+        quint32 vertexCount;
+        quint32 indexCount;
+    };
+    static const char magic[8];
+    static const quint32 version = 1;
+
+    QString directory;
+    bool available = false;
+    // Bytes of entries in the directory, shared by the caches of all documents. -1 until the first store scans it.
+    static qint64 size;
+
+    QString entryPath(const QByteArray &key) const;
+    void prune();
+};
+
+
+#endif //RT3_GEOMETRYCACHE_H
@@ -24,6 +24,8 @@
 
 #include "DisplayManager.h"
 #include "Renderer.h"
+#include "GeometryCache.h"
+#include <brlcad/MemoryDatabase.h>
 
 class GeometryRenderer:public Renderer {
 public:
@@ -32,21 +34,76 @@ public:
 
     // this is called by Display to render a single frame
     void render() override;
+    void renderObjectIds(int lineWidth);
     void refreshForVisibilityAndSolidChanges();
     void clearSolidIfAvailable(int objectId);
     void clearObject(int objectId);
+    void clearObjects(const QVector<int>& objectIds);
+    void removeObjects(const QVector<int>& objectIds);
+    void setHighlightedObjectId(int objectId);
+    void setMinimumVisibleObjectSize(double size);
+    void setShaded(bool shaded);
+    void setPreviewObject(const BRLCAD::Object& object);
+    void clearPreview();
+    void setTransform(int objectId, const QMatrix4x4& transform);
+    void clearTransforms(int objectId);
+
+    bool isShaded() const {
+        return shaded;
+    }
+
+    int getHighlightedObjectId() const {
+        return highlightedObjectId;
+    }
+
+    const QVector<int> &getVisibleObjectIds() const {
+        return visibleObjectIds;
+    }
+
+    // Increased whenever the set of visible solids or their geometry changes
+    unsigned int getVisibleObjectsVersion() const {
+        return visibleObjectsVersion;
+    }
 
 private:
     Document* document;
     float defaultWireColor[3] = {1.0,.1,.4};
+    float highlightColor[3] = {1.0,.55,0};
+    const int highlightLineWidth = 2;
+    int highlightedObjectId = -1;
+    unsigned int visibleObjectsVersion = 0;
+    double minimumVisibleObjectSize = 0;
+    bool shaded = false;
+    GeometryCache geometryCache;
 
 
     void drawSolid(int objectId);
+    void setSolidColor(int objectId);
+    void drawDisplayList(int objectId, int displayListId);
+    void updateDisplayLists();
+    void updatePreviewDisplayLists();
+    void copyToPreviewDatabase(const QString& objectName);
 
     // Contains generated display list alone with corresponding objectId. objectId is the key. displayListId is value.
     QHash<int, int>             objectIdDisplayListIdMap;
 
+    // Largest extent of the bounding box of each plotted solid. Used to cull small solids while interacting.
+    QHash<int, double>          objectIdSizeMap;
+
+    // An edited object that is not in the database yet. It is plotted from a scratch database holding only the object
+    // and the combinations on the paths to its visible instances, and drawn instead of those instances.
+    BRLCAD::MemoryDatabase *previewDatabase = nullptr;
+    QString previewObjectName;
+    QSet<QString> previewDatabaseObjectNames;
+    QVector<int> previewObjectIds;
+    QHash<int, int> previewObjectIdDisplayListIdMap;
+    bool previewPlotPending = false;
+
+    // Solids drawn moved by a matrix instead of where they were plotted. See setTransform.
+    QHash<int, QMatrix4x4> objectIdTransformMap;
+
     QVector<int> visibleDisplayListIds;
+    QVector<int> visibleObjectIds; // objectId of each display list in visibleDisplayListIds
     QVector<int> objectsToBeDisplayedIds;
 };
 
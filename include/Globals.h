@@ -1,6 +1,7 @@
 #ifndef GLOBALS_H
 #define GLOBALS_H
 
+#include <QMutex>
 #include "Display.h"
 
 class MainWindow;
@@ -10,6 +11,9 @@ class Globals{
 public:
     static QSSPreprocessor *theme;
     static MainWindow *mainWindow;
+    // librt keeps global state (rt_uniresource) that every database uses, so the threads that read or write
+    // databases (loading, saving, the edit journal) and the GUI take turns. Recursive, so GUI calls can nest.
+    static QMutex librtMutex;
 };
 
 
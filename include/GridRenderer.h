@@ -3,6 +3,8 @@
 #define RT3_GRIDRENDERER_H
 
 
+#include <QOpenGLShaderProgram>
+#include <QOpenGLBuffer>
 #include "Renderer.h"
 #include "Display.h"
 
@@ -14,9 +16,18 @@ public:
     void render() override;
 
     GridRenderer(Display *display);
+    ~GridRenderer() override;
 
 private:
     Display * display;
+    float lineColor[3] = {.3, .3, .3};
+    const float fadeDistanceInVerticalSpans = 3;
+
+    bool initialized = false;
+    QOpenGLShaderProgram *program = nullptr;   // nullptr if the shaders could not be built
+    QOpenGLBuffer quadBuffer;
+
+    void initialize();
 };
 
 
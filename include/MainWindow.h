@@ -6,11 +6,14 @@
 #include <QtWidgets/QMdiArea>
 #include <unordered_map>
 #include "Document.h"
+#include "DocumentLoader.h"
+#include "DocumentSaver.h"
 #include "Dockable.h"
 #include "QSSPreprocessor.h"
 #include <QStatusBar>
 #include <QMenuBar>
 #include <QComboBox>
+#include <QUndoGroup>
 
 class Document;
 
@@ -41,6 +44,7 @@ private:
     QLabel *statusBarPathLabel;
     QComboBox * currentViewport;
     QAction* singleViewAct[4];
+    QUndoGroup *undoGroup;
 	
     // Stores pointers to all the currently opened documents. Item removed when document is closed. Key is documents ID.
     std::unordered_map<int, Document*> documents;
@@ -51,6 +55,17 @@ private:
 
     // The ID of the active document.
     int activeDocumentId = -1;
+
+    // Only one file is opened at a time. loadingDocumentId is -1 until the loader has opened the database.
+    DocumentLoader *documentLoader = nullptr;
+    int loadingDocumentId = -1;
+    int loadedTopObjectCount = 0;
+    int topObjectCount = 0;
+    QPushButton *cancelLoadingButton;
+
+    // Journals of crashed sessions waiting to be offered for recovery, and the one whose document is being opened
+    QStringList pendingJournalRecoveries;
+    QString recoveringJournal;
 	
     void prepareUi();
     void loadTheme();
@@ -58,7 +73,8 @@ private:
 
     void newFile(); // empty new file
     void openFile(const QString& filePath);
-    bool saveFile(const QString& filePath);
+    void saveFile(const QString& filePath);
+    void recoverNextJournal();
 
     QAction *themeAct[2];
 	
@@ -74,6 +90,7 @@ public slots:
     void onActiveDocumentChanged(int newIndex);
     void tabCloseRequested(int i) ;
     void objectTreeWidgetSelectionChanged(int objectId);
+    void objectTreeWidgetObjectsSelectionChanged(QVector<int> objectIds);
     void closeButtonPressed();
     void minimizeButtonPressed();
     void maximizeButtonPressed();
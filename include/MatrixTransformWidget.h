@@ -4,14 +4,43 @@
 
 
 #include <include/Document.h>
+#include <brlcad/Combination.h>
 #include "DataRow.h"
 
+/*
+ * Moves, rotates or scales an object within its parent combination. While typing or dragging a value only the
+ * matrix used to draw the object changes. The matrix is set on the parent in the database (and re-plotted) when
+ * the text box is done with or the window is closed.
+ */
 class MatrixTransformWidget : public DataRow{
 public:
     enum TransformType {Translate, Rotate, Scale};
     MatrixTransformWidget(Document * document, int childObjectId, TransformType transformType );
+    ~MatrixTransformWidget() override;
+
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
 private:
     static QHash<int,QWidget*> widgets;
+
+    Document *document = nullptr;
+    int childObjectId;
+    TransformType transformType;
+
+    // A copy of the parent combination and its leaf for the child. The leaf holds the edited matrix for the preview;
+    // apply sets only that matrix on the parent's current state.
+    BRLCAD::Combination *parentObject = nullptr;
+    BRLCAD::Combination::TreeNode leaf;
+    double initialMatrix[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    // The leaf's matrix in the database. The plotted solids are at the place it gives them.
+    double appliedMatrix[16];
+    // Accumulated matrix from the top object to the parent. Maps the parent's coordinates to world coordinates.
+    QMatrix4x4 parentToWorld;
+    bool edited = false;
+
+    void edit();
+    void apply();
 };
 
 
@@ -4,15 +4,27 @@
 
 
 #include <include/DataRow.h>
+#include <include/DragEditLineEdit.h>
+#include <functional>
 #include <brlcad/Object.h>
 #include <brlcad/MemoryDatabase.h>
 #include "QVBoxWidget.h"
 #include "Document.h"
 
+// Lets TypeSpecificProperties rebind fields of any primitive type
+class ObjectDataFieldBase : public QVBoxWidget {
+public:
+    // Points the field at obj and shows its values. obj must be of the type the field was made for.
+    virtual void bindObject(void *obj) = 0;
+};
+
 template<typename T>
-class ObjectDataField : public QVBoxWidget {
+class ObjectDataField : public ObjectDataFieldBase {
 private:
     Document *document;
+    T *object;
+    // Copies the values of object into the text boxes
+    std::function<void()> readValues;
 public:
 
     ObjectDataField(
@@ -24,29 +36,38 @@ public:
             size_t count,
             const QStringList & indices,
             QString title
-    ) : QVBoxWidget() , document(document) {
-
-        T* object = reinterpret_cast<T*>(obj);
+    ) : document(document), object(reinterpret_cast<T*>(obj)) {
         if (object == nullptr) return;
 
         setTitle(indices, title);
 
+        std::vector<DataRow*> rows;
         for (int c=start; c < start+count; c++) {
-            BRLCAD::Vector3D val = ((*object).*getter)(c);
             DataRow *row = new DataRow(3, c==start,indices[c-start], this);
             for (int i = 0; i < 3; i++) {
-                row->getTextBoxes()[i]->setText(QString::number(val.coordinates[i]));
                 if (c!=start+count-1) row->getTextBoxes()[i]->setStyleSheet("border-bottom-width: 0px");
 
-                connect(row->getTextBoxes()[i], &QLineEdit::textEdited, this, [setter,getter,document,object,row,i,c]() {
+                connect(row->getTextBoxes()[i], &QLineEdit::textEdited, this, [this,setter,getter,row,i,c]() {
                     BRLCAD::Vector3D val = ((*object).*getter)(c);
                     val.coordinates[i] = row->getTextBoxes()[i]->text().toDouble();
                     ((*object).*setter)(c,val);
-                    document->modifyObject(object);
+                    this->document->previewObject(object);
                 });
+                connectCommit(row->getTextBoxes()[i]);
             }
             addWidget(row);
+            rows.push_back(row);
         }
+
+        readValues = [this,getter,start,rows]() {
+            for (size_t c = start; c < start + rows.size(); c++) {
+                BRLCAD::Vector3D val = ((*object).*getter)(c);
+                for (int i = 0; i < 3; i++) {
+                    rows[c - start]->getTextBoxes()[i]->setText(QString::number(val.coordinates[i]));
+                }
+            }
+        };
+        readValues();
     }
 
 
@@ -60,29 +81,38 @@ public:
             size_t count,
             const QStringList & indices,
             QString title
-    ) : QVBoxWidget() , document(document) {
-
-        T* object = reinterpret_cast<T*>(obj);
+    ) : document(document), object(reinterpret_cast<T*>(obj)) {
         if (object == nullptr) return;
 
         setTitle(indices, title);
 
+        std::vector<DataRow*> rows;
         for (int c=start; c < start+count; c++) {
-            BRLCAD::Vector3D val = ((*object).*getter)(c);
             DataRow *row = new DataRow(3, c==start,indices[c-start], this);
             for (int i = 0; i < 3; i++) {
-                row->getTextBoxes()[i]->setText(QString::number(val.coordinates[i]));
                 if (c!=start+count-1) row->getTextBoxes()[i]->setStyleSheet("border-bottom-width: 0px");
 
-                connect(row->getTextBoxes()[i], &QLineEdit::textEdited, this, [setter,getter,document,object,row,i,c]() {
+                connect(row->getTextBoxes()[i], &QLineEdit::textEdited, this, [this,setter,getter,row,i,c]() {
                     BRLCAD::Vector3D val = ((*object).*getter)(c);
                     val.coordinates[i] = row->getTextBoxes()[i]->text().toDouble();
                     ((*object).*setter)(c,val);
-                    document->modifyObject(object);
+                    this->document->previewObject(object);
                 });
+                connectCommit(row->getTextBoxes()[i]);
             }
             addWidget(row);
+            rows.push_back(row);
         }
+
+        readValues = [this,getter,start,rows]() {
+            for (size_t c = start; c < start + rows.size(); c++) {
+                BRLCAD::Vector3D val = ((*object).*getter)(c);
+                for (int i = 0; i < 3; i++) {
+                    rows[c - start]->getTextBoxes()[i]->setText(QString::number(val.coordinates[i]));
+                }
+            }
+        };
+        readValues();
     }
 
     ObjectDataField(
@@ -91,9 +121,7 @@ public:
             BRLCAD::Vector3D (T::*getter)() const,
             void (T::*setter)(const BRLCAD::Vector3D&),
             QString title
-    ) : QVBoxWidget() , document(document) {
-
-        T* object = reinterpret_cast<T*>(obj);
+    ) : document(document), object(reinterpret_cast<T*>(obj)) {
         if (object == nullptr) return;
 
         if (title != "") {
@@ -102,21 +130,26 @@ public:
             addWidget(titleWidget);
         }
 
-        BRLCAD::Vector3D val = ((*object).*getter)();
-
         DataRow* row = new DataRow(3, true,"", this);
         for (int i = 0; i < 3; i++) {
-            row->getTextBoxes()[i]->setText(QString::number(val.coordinates[i]));
-
-            connect(row->getTextBoxes()[i], &QLineEdit::textEdited, this, [setter,getter,document,object,row,i]() {
+            connect(row->getTextBoxes()[i], &QLineEdit::textEdited, this, [this,setter,getter,row,i]() {
                 BRLCAD::Vector3D val = ((*object).*getter)();
                 val.coordinates[i] = row->getTextBoxes()[i]->text().toDouble();
                 ((*object).*setter)(val);
-                document->modifyObject(object);
+                this->document->previewObject(object);
             });
+            connectCommit(row->getTextBoxes()[i]);
         }
 
         addWidget(row);
+
+        readValues = [this,getter,row]() {
+            BRLCAD::Vector3D val = ((*object).*getter)();
+            for (int i = 0; i < 3; i++) {
+                row->getTextBoxes()[i]->setText(QString::number(val.coordinates[i]));
+            }
+        };
+        readValues();
     }
 
     ObjectDataField(
@@ -125,9 +158,7 @@ public:
             double (T::*getter)() const,
             void (T::*setter)(const double),
             QString title
-    ) : QVBoxWidget() , document(document) {
-
-        T* object = reinterpret_cast<T*>(obj);
+    ) : document(document), object(reinterpret_cast<T*>(obj)) {
         if (object == nullptr) return;
 
         if (title != "") {
@@ -136,20 +167,46 @@ public:
             addWidget(titleWidget);
         }
 
-        double val = ((*object).*getter)();
-
         DataRow* row = new DataRow(1, false,"", this);
         row->getTextBoxes()[0]->setAlignment(Qt::AlignLeft);
-        row->getTextBoxes()[0]->setText(QString::number(val));
 
-        connect(row->getTextBoxes()[0], &QLineEdit::textEdited, this, [setter,getter,document,object,row,this]() {
+        connect(row->getTextBoxes()[0], &QLineEdit::textEdited, this, [this,setter,row]() {
             ((*object).*setter)(row->getTextBoxes()[0]->text().toDouble());
-            document->modifyObject(object);
+            this->document->previewObject(object);
         });
+        connectCommit(row->getTextBoxes()[0]);
 
         addWidget(row);
+
+        readValues = [this,getter,row]() {
+            row->getTextBoxes()[0]->setText(QString::number(((*object).*getter)()));
+        };
+        readValues();
+    }
+
+
+    void bindObject(void *obj) override {
+        object = reinterpret_cast<T*>(obj);
+        if (object != nullptr && readValues) readValues();
     }
 
+    // The previewed edit is applied when the text box loses focus or Return is pressed. While the value is being
+    // dragged it is only previewed, and it is applied on release.
+    void connectCommit(QLineEdit *textBox) {
+        Document *document = this->document;
+        connect(textBox, &QLineEdit::editingFinished, this, [document]() {
+            document->commitPreview();
+        });
+
+        DragEditLineEdit *dragEditLineEdit = qobject_cast<DragEditLineEdit *>(textBox);
+        if (dragEditLineEdit == nullptr) return;
+        connect(dragEditLineEdit, &DragEditLineEdit::dragStarted, this, [document]() {
+            document->setInteractiveEdit(true);
+        });
+        connect(dragEditLineEdit, &DragEditLineEdit::dragFinished, this, [document]() {
+            document->setInteractiveEdit(false);
+        });
+    }
 
     void setTitle(const QStringList &indices, const QString &title) {
         if (title != "") {
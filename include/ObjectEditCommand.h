@@ -0,0 +1,68 @@
+/*               O B J E C T E D I T C O M M A N D . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file ObjectEditCommand.h */
+
+#ifndef RT3_OBJECTEDITCOMMAND_H
+#define RT3_OBJECTEDITCOMMAND_H
+
+#include <memory>
+#include <QUndoCommand>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QStringList>
+#include <brlcad/Object.h>
+
+class Document;
+
+/*
+ * Undoable change of one or more objects, from the objects' states before the edit to the states after it.
+ * The objects of a bulk edit are applied together (see Document::applyObjectStates).
+ *
+ * States are immutable and shared: the state after a command is the same instance as the state before the next
+ * command on that object (see Document::getObjectState), so the stack stores one copy of each object per step
+ * and nothing for the rest of the database.
+ *
+ * Edits of the same object that follow each other within mergeInterval are merged into one command, so typing a
+ * number into a property field is a single undo step and the intermediate states are released.
+ */
+class ObjectEditCommand : public QUndoCommand {
+public:
+    // before[i] and after[i] are states of the same object
+    ObjectEditCommand(Document *document, QVector<std::shared_ptr<const BRLCAD::Object>> before,
+                      QVector<std::shared_ptr<const BRLCAD::Object>> after);
+
+    void undo() override;
+    void redo() override;
+    int id() const override;
+    bool mergeWith(const QUndoCommand *other) override;
+
+private:
+    const qint64 mergeInterval = 1000; // ms
+
+    Document *document;
+    QStringList objectNames;
+    QVector<std::shared_ptr<const BRLCAD::Object>> before;
+    QVector<std::shared_ptr<const BRLCAD::Object>> after;
+    QElapsedTimer lastEditTimer;
+    bool firstRedo = true;
+};
+
+
+#endif //RT3_OBJECTEDITCOMMAND_H
@@ -6,7 +6,7 @@
 #include <QHash>
 #include <QSet>
 #include <QVector>
-#include "brlcad/MemoryDatabase.h"
+#include "brlcad/ConstDatabase.h"
 #include <brlcad/Combination.h>
 #include <functional>
 #include <set>
@@ -35,22 +35,64 @@ public:
         FullyVisible,
     };
 
-    ObjectTree(BRLCAD::MemoryDatabase* database);
+    // A subtree read from the database but not added to the tree yet. Nodes are in depth first order.
+    // DocumentLoader builds these on a worker thread so that the tree can be filled in one top object at a time.
+    struct Fragment {
+        struct Node {
+            QString name;
+            int parentIndex;    // index of the parent in nodes, -1 for the top object
+            bool drawable;
+            ColorInfo color;    // the combination's own color. hasColor is false if it does not set one
+        };
+        QVector<Node> nodes;
+    };
+
+    // What a structural edit changed, so that views of the tree can be patched instead of rebuilt
+    struct Delta {
+        QVector<int> removedObjectIds;  // every id of the removed subtrees. They are reused only by later edits.
+        QVector<int> addedObjectIds;    // roots of the added subtrees
+        QVector<int> changedObjectIds;  // objects whose list of children changed
+
+        bool isEmpty() const
+        {
+            return changedObjectIds.isEmpty();
+        }
+    };
+
+    explicit ObjectTree(BRLCAD::ConstDatabase* database, bool addTopObjects = true);
 
     int lastAllocatedId = 0;
 
     void traverseSubTree(int rootOfSubTreeId, bool traverseRoot, const std::function<bool(int)>&);
 
     void changeVisibilityState(int objectId, bool visible);
+    // Colors the subtree from the cached colors of the combinations in it. Nothing is read from the database.
     void buildColorMap(int rootObjectId);
+    // Caches the color of an edited combination and, if it changed, colors the subtrees of its instances again
+    void updateColor(const BRLCAD::Combination& combination);
     int addTopObject(QString name);
 
+    // Reads the subtree of a top object. Nothing else may use the database while this runs.
+    static void buildFragment(BRLCAD::ConstDatabase* database, const QString& topObjectName, Fragment& fragment);
+    // Returns the objectId of the top object of the fragment
+    int addFragment(const Fragment& fragment, int parentObjectId = 0);
+
+    // Brings the children of every instance of combination in line with its tree. Children that are still there keep
+    // their ids and subtrees, removed ones are dropped with their subtrees and new ones are read from the database.
+    Delta updateChildren(const BRLCAD::Combination& combination);
+
         // getters
-    BRLCAD::MemoryDatabase* getDatabase() const
+    BRLCAD::ConstDatabase* getDatabase() const
     {
 	    return database;
     }
 
+    // Used when the document replaces its mapped database with an in-memory one holding the same objects
+    void setDatabase(BRLCAD::ConstDatabase* database)
+    {
+        this->database = database;
+    }
+
     QHash<int, QVector<int>>& getChildren()
     {
         return objectIdChildrenObjectIdsMap;
@@ -84,27 +126,61 @@ public:
     QHash<int, VisibilityState> &getObjectVisibility() {
         return objectIdVisibilityStateMap;
     }
+
+    // Ids of every instance of the object in the tree, without traversing it
+    QVector<int> getObjectIds(const QString& name) const
+    {
+        return nameObjectIdsMap.value(name);
+    }
+
+    // Ids of the instances of every object whose name contains text, ignoring case. Names are looked up in a trigram
+    // index, so only the names that have all the trigrams of text are compared.
+    QVector<int> findObjects(const QString& text) const;
+
+    // Bounding boxes of the plotted solids, in world coordinates. Set by GeometryRenderer when it plots a solid.
+    void setSolidBoundingBox(int objectId, const BoundingBox& boundingBox);
+    void removeSolidBoundingBox(int objectId);
+
+    const QHash<int, BoundingBox>& getSolidBoundingBoxMap() const
+    {
+        return solidBoundingBoxMap;
+    }
+
+    // Extends boundingBox by the box of objectId's subtree. Boxes of combinations are unions of the boxes of their
+    // children and are cached until something below them changes, so this is arithmetic over the uncached nodes only.
+    // Returns false if a solid in the subtree has not been plotted, in which case the box leaves it out.
+    bool getBoundingBox(int objectId, BoundingBox& boundingBox);
 	
 private:
-    BRLCAD::MemoryDatabase* database;
+    BRLCAD::ConstDatabase* database;
+
+    // ids of removed objects, given to new objects before new ids are allocated
+    QVector<int> freeObjectIds;
+
+    // Trigram index over the lower case names of the objects ever added. Names of removed objects stay in it and are
+    // skipped by findObjects.
+    QStringList indexedNames;
+    QHash<QString, int> indexedNameIndexMap;
+    QHash<quint64, QVector<int>> trigramNameIndicesMap;
+
+    void indexName(const QString& name);
+    int allocateObjectId();
+    void removeSubTree(int objectId, QVector<int>& removedObjectIds);
+    void invalidateBoundingBoxes(int objectId);
 	
-	// this class is used for traversing the MemoryDatabase and produce the tree
+	// this class is used for traversing the database and produce a Fragment of the tree
     class ObjectTreeCallback : public BRLCAD::ConstDatabase::ObjectCallback {
     public:
-        ObjectTreeCallback(ObjectTree* objectTree, QString& objectName, const int& parentObjectId) :
-            objectTree(objectTree),
-            objectName(objectName),
-            parentObjectId(parentObjectId),
-            currentObjectPath(objectTree->fullPathMap[parentObjectId] + "/" + objectName) {}
+        ObjectTreeCallback(BRLCAD::ConstDatabase* database, Fragment& fragment, const int nodeIndex) :
+            database(database),
+            fragment(fragment),
+            nodeIndex(nodeIndex) {}
         void operator()(const BRLCAD::Object& object) override;
     private:
-        int objectId = -1;
-        ObjectTree* objectTree = nullptr;
-        QString objectName;
-        const int& parentObjectId;
-    	QString currentObjectPath;
-        QVector<int>* childrenNames = nullptr;
-        void traverseSubTree(const BRLCAD::Combination::ConstTreeNode& node) const; //traverse the boolean tree of the MemoryDatabase
+        BRLCAD::ConstDatabase* database;
+        Fragment& fragment;
+        const int nodeIndex;
+        void traverseSubTree(const BRLCAD::Combination::ConstTreeNode& node) const; //traverse the boolean tree of the combination
     };
 
     // Stores the object tree in  {parent's object id (key), children's object ids (value)} format
@@ -116,17 +192,34 @@ private:
 	// Object id to it's name mapping
     QHash<int, QString>         nameMap;
 
+    // Object name to the ids of its instances. Names in nameMap are shared with the keys of this map,
+    // so an object that appears many times in the tree keeps one copy of its name.
+    QHash<QString, QVector<int>> nameObjectIdsMap;
+
     // Object id to it's full path mapping
     QHash<int, QString>         fullPathMap;
 
-    // Object id to it's full path mapping
+    // Object id to it's color, inherited from the closest combination above it that sets one
     QHash<int, ColorInfo>         colorMap;
 
+    // Combination name to the color set by the combination itself. hasColor is false if it does not set one.
+    QHash<QString, ColorInfo>   combinationColorMap;
+
     // Get all objects that are not combinations. (ie. these are also the objects that can be drawn) //todo _GLOBAL?
     QSet<int>                   drawableObjectIds;
 
 
     QHash<int, VisibilityState>             objectIdVisibilityStateMap;
+
+    QHash<int, BoundingBox>     solidBoundingBoxMap;
+
+    // Box of a combination's subtree, and whether every solid in it was plotted. A combination only has an entry if
+    // the combinations below it have one, so invalidating can stop at the first ancestor without an entry.
+    struct SubTreeBoundingBox {
+        BoundingBox boundingBox;
+        bool complete;
+    };
+    QHash<int, SubTreeBoundingBox> boundingBoxCache;
 };
 
 #endif
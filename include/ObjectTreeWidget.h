@@ -44,9 +44,17 @@ public:
     void refreshItemTextColors();
     const QHash<int, QTreeWidgetItem *> &getObjectIdTreeWidgetItemMap() const;
     void build(int objectId, QTreeWidgetItem* parent = nullptr);
+    // Patches the items after ObjectTree::updateChildren
+    void applyDelta(const ObjectTree::Delta& delta);
+    // Shows only the objects whose name contains text, their ancestors and their subtrees. Empty text shows everything.
+    void filter(const QString& text);
+    void selectObject(int objectId);
 private:
     Document* document;
     QHash <int, QTreeWidgetItem*> objectIdTreeWidgetItemMap;
+    bool multipleSelected = false;
+    QString filterText;
+    QVector<int> hiddenObjectIds; // items hidden by the filter
 
     QColor colorFullVisible;
     QColor colorSomeChildrenVisible;
@@ -55,6 +63,8 @@ private:
 signals:
     void visibilityButtonClicked(int objectId);
     void selectionChanged(int objectId);
+    // Emitted instead of selectionChanged while more than one object is selected
+    void objectsSelectionChanged(QVector<int> objectIds);
 
 
 };
@@ -82,9 +82,13 @@ public:
 
     void centerToCurrentSelection();
 
+    void centerToBoundingBox(const BoundingBox& boundingBox);
+
     QVector3D getEyePosition();
 
     double getVerticalSpan();
+
+    BRLCAD::Ray3D rayThroughScreenPoint(int x, int y) const;
 };
 
 
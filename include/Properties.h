@@ -12,19 +12,37 @@
 #include "QVBoxWidget.h"
 
 class Document;
+class TypeSpecificProperties;
+class BulkProperties;
 class Properties: public QVBoxWidget{
 public:
     explicit Properties(Document & document);
+    ~Properties() override;
     void bindObject(const int objectId);
+    // Shows the bulk editor for several selected objects
+    void bindObjects(const QVector<int> &objectIds);
+    // Rebinds the current object after it was changed by something other than the panel (ex: undo).
+    // Objects that were removed from the tree meanwhile are dropped.
+    void refresh();
+    // Shows nothing
+    void clear();
 
 private:
+    int objectId = -1;
+    QVector<int> objectIds; // the objects in the bulk editor, empty when one object is bound
     QString name, fullPath, objectType;
+    // Copy of the bound object, edited by the fields of currentTypeSpecificProperties. Each document has its own.
+    BRLCAD::Object * object = nullptr;
 
 	// UI components
     Document & document;
     QLabel * nameWidget;
     QLabel * fullPathWidget;
     QVBoxWidget * typeSpecificPropertiesArea;
+    BulkProperties * bulkProperties;
+    TypeSpecificProperties * currentTypeSpecificProperties = nullptr;
+    // One panel per TypeSpecificProperties::getPoolKey
+    QHash<QString, TypeSpecificProperties*> typeSpecificPropertiesPool;
 };
 
 
@@ -0,0 +1,84 @@
+/*                       R A Y P I C K E R . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file RayPicker.h */
+
+#ifndef RT3_RAYPICKER_H
+#define RT3_RAYPICKER_H
+
+#include <vector>
+#include <brlcad/cicommon.h>
+#include "Utils.h"
+
+class Document;
+
+/*
+ * Picks objects on the CPU by intersecting a ray with a bounding volume hierarchy (BVH) of the bounding boxes of
+ * the visible solids. Unlike Display::pickObject this does not need a read back from the GPU.
+ *
+ * The BVH is rebuilt lazily when GeometryRenderer reports that the visible solids changed.
+ * Optionally the result can be confirmed by shooting a single ray at the candidate solids only,
+ * so the raytracer never has to prepare the whole database.
+ */
+class RayPicker {
+public:
+    explicit RayPicker(Document *document);
+
+    // Returns the objectId of the picked solid or -1
+    int pick(const BRLCAD::Ray3D &ray, bool confirmWithRaytrace);
+
+private:
+    struct Node {
+        BoundingBox boundingBox;
+        int left = -1;      // children in nodes. -1 for leaves
+        int right = -1;
+        int first = 0;      // range of leaf solids in solids
+        int count = 0;
+    };
+
+    struct Solid {
+        int objectId;
+        BoundingBox boundingBox;
+    };
+
+    struct Candidate {
+        int objectId;
+        double entryDistance;   // distances along the ray where it enters and exits the solid's bounding box
+        double exitDistance;
+        double volume;
+    };
+
+    const int maxSolidsPerLeaf = 4;
+
+    Document *document;
+    std::vector<Node> nodes;
+    std::vector<Solid> solids;
+    unsigned int builtVisibleObjectsVersion = 0;
+    bool built = false;
+
+    void build();
+    int buildNode(int first, int count);
+    void collectCandidates(const BRLCAD::Ray3D &ray, std::vector<Candidate> &candidates) const;
+    int confirm(const BRLCAD::Ray3D &ray, const std::vector<Candidate> &candidates) const;
+
+    static bool intersect(const BoundingBox &boundingBox, const BRLCAD::Ray3D &ray, double &entryDistance, double &exitDistance);
+};
+
+
+#endif //RT3_RAYPICKER_H
@@ -53,7 +53,6 @@ protected:
 
 private:
     Document* document;
-    BRLCAD::ConstDatabase& m_database;
     QMatrix4x4             m_transformation;
     QImage                 m_image;
     bool                   m_imageUpTodate;
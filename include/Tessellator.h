@@ -0,0 +1,86 @@
+/*                     T E S S E L L A T O R . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file Tessellator.h */
+
+#ifndef RT3_TESSELLATOR_H
+#define RT3_TESSELLATOR_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QTemporaryFile>
+#include "Utils.h"
+
+class Document;
+struct db_i;
+struct directory;
+
+/*
+ * Converts solids into triangle meshes with BRL-CAD's facetizer (the tessellate function of each primitive
+ * followed by NMG triangulation), for the shaded display mode.
+ *
+ * coreinterface does not expose tessellation, so librt is used on the document's .g file. Objects changed since
+ * the last save are read from a small overlay file holding only those objects, written when one of them is first
+ * tessellated after a change, and the matrices of paths through changed combinations come from the document.
+ * The rest of the database is never written out, so an edit does not cost a save and does not load a mapped file.
+ * The same librt access is used to compute the keys of GeometryCache, for paths without changed objects.
+ */
+class Tessellator {
+public:
+    explicit Tessellator(Document *document);
+    virtual ~Tessellator();
+
+    // Tessellates the solid at fullPath (ex: "/all.g/wheel.c/tire.s") with the matrices of the path applied.
+    // Returns false if the solid can not be tessellated, in which case mesh is left empty.
+    bool tessellate(const QString &fullPath, TriangleMesh &mesh);
+
+    bool cacheKey(const QString &fullPath, bool shaded, QByteArray &key);
+
+    // Must be called when an object of the document's database is modified or added
+    void invalidate(const QString &objectName);
+    // Called after a successful save of objectNames to the document's file
+    void saved(const QStringList &objectNames);
+
+    double getRelativeTolerance() const {
+        return relativeTolerance;
+    }
+
+private:
+    Document *document;
+    db_i *baseDbip = nullptr;       // the document's file
+    db_i *overlayDbip = nullptr;    // the changed objects
+    QTemporaryFile *overlayFile = nullptr;
+    // objects that differ from the document's file. All of them for a document that was never saved.
+    QSet<QString> changedObjectNames;
+
+    const double relativeTolerance = 0.01;
+    const double distanceTolerance = 0.0005;
+
+    bool openBase();
+    bool openOverlay();
+    static void close(db_i *&dbip);
+    bool isChanged(const QStringList &objectNames) const;
+    bool lookUp(const QString &fullPath, db_i *&dbip, directory *&leaf, double *matrix);
+};
+
+
+#endif //RT3_TESSELLATOR_H
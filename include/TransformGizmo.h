@@ -0,0 +1,97 @@
+/*                   T R A N S F O R M G I Z M O . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file TransformGizmo.h */
+
+#ifndef RT3_TRANSFORMGIZMO_H
+#define RT3_TRANSFORMGIZMO_H
+
+#include <QMatrix4x4>
+#include <QPointF>
+#include <QVector3D>
+
+class Display;
+class Document;
+
+/*
+ * Handles drawn on a display at the center of the object selected in the tree, one per world axis, to move,
+ * rotate or scale the object with the mouse.
+ *
+ * While a handle is dragged the change is only a matrix given to GeometryRenderer::setTransform, so the plotted
+ * geometry is drawn moved and nothing is plotted again. On release the change is written to the matrix of the
+ * object in its parent combination with Document::setInstanceMatrix, which re-plots the object once.
+ */
+class TransformGizmo {
+public:
+    enum Mode {Translate, Rotate, Scale};
+
+    TransformGizmo(Display *display, Document *document);
+
+    // Called by Display after the geometry, with the display's matrices loaded
+    void render();
+
+    // Returns true if (x, y) is on a handle. The following mouse moves then go to drag until release.
+    bool press(int x, int y);
+    void drag(int x, int y);
+    void release();
+
+    bool isDragging() const {
+        return dragAxis != -1;
+    }
+
+    Mode getMode() const {
+        return mode;
+    }
+
+    void setMode(Mode mode) {
+        this->mode = mode;
+    }
+
+private:
+    Display *display;
+    Document *document;
+    Mode mode = Translate;
+
+    const float handleLengthPerVerticalSpan = .12f;
+    const float handlePickDistance = 6; // pixels
+    const int circleSegments = 48;
+    const float axisColors[3][3] = {{.9f, .2f, .2f}, {.2f, .8f, .2f}, {.2f, .4f, .95f}};
+    const float draggedAxisColor[3] = {1.f, .85f, .1f};
+    const float minimumScale = .01f;
+
+    // the object the handles are shown for, and its center in world coordinates
+    int objectId = -1;
+    QVector3D center;
+
+    int dragAxis = -1;
+    QPointF pressPoint;
+    QMatrix4x4 dragTransform; // change made by the drag so far, in world coordinates
+    QMatrix4x4 pathMatrix;    // maps the coordinates of the object's parent to world
+    QMatrix4x4 instanceMatrix;
+
+    bool updateObject();
+    float handleLength() const;
+    QVector3D axis(int i) const;
+    QPointF toScreen(const QVector3D &point) const;
+    QVector<QVector3D> handlePoints(int i) const;
+    static float distanceToSegment(const QPointF &point, const QPointF &a, const QPointF &b);
+};
+
+
+#endif //RT3_TRANSFORMGIZMO_H
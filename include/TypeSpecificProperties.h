@@ -6,16 +6,48 @@
 #include <brlcad/MemoryDatabase.h>
 #include <QtWidgets/QFrame>
 #include <QtWidgets/QVBoxLayout>
+#include <QtWidgets/QCheckBox>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QPushButton>
 #include "Document.h"
 
+class ObjectDataFieldBase;
+
+/*
+ * Property fields of one object type. The fields are made once for the first object of the type and later objects
+ * of the same type are shown by rebinding them, so Properties keeps one of these per type.
+ */
 class TypeSpecificProperties: public QVBoxWidget {
 public:
-    TypeSpecificProperties(Document &document, BRLCAD::Object *object, const int i);
+    TypeSpecificProperties(Document &document, BRLCAD::Object *object, const int objectId);
+
+    // Objects that can share one panel have the same key. Arb8 panels also depend on the number of vertices.
+    static QString getPoolKey(const BRLCAD::Object *object);
+
+    void bindObject(BRLCAD::Object *object, const int objectId);
+    void addField(ObjectDataFieldBase *field);
+
+    Document &getDocument() const {
+        return document;
+    }
+
+    BRLCAD::Object *getObject() const {
+        return object;
+    }
 
 protected:
     Document& document;
     BRLCAD::Object *object;
     QVBoxLayout *l;
+    QVector<ObjectDataFieldBase*> fields;
+
+    // Combination only
+    QVBoxWidget *childrenList = nullptr;
+    QVector<QLabel*> childLabels;
+    QCheckBox *hasColorCheck = nullptr;
+    QPushButton *colorButton = nullptr;
+
+    void addCombinationFields();
 };
 
 
@@ -6,10 +6,12 @@
 #include <functional>
 #include <utility>
 #include <QtWidgets/QLabel>
+#include <QMatrix4x4>
 #include "brlcad/cicommon.h"
 #include "QVBoxWidget.h"
 #include "QHBoxWidget.h"
 #include <chrono>
+#include <cfloat>
 #include <stack>
 #include <iostream>
 using namespace std::chrono;
@@ -36,8 +38,77 @@ struct ColorInfo {
     }
 };
 
+// Axis aligned bounding box in model coordinates
+struct BoundingBox {
+    double minima[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+    double maxima[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+
+    bool isEmpty() const {
+        return minima[0] > maxima[0] || minima[1] > maxima[1] || minima[2] > maxima[2];
+    }
+
+    void extend(const double *point) {
+        for (int i = 0; i < 3; i++) {
+            if (point[i] < minima[i]) minima[i] = point[i];
+            if (point[i] > maxima[i]) maxima[i] = point[i];
+        }
+    }
+
+    // vertices is an array of vertexCount vertices of floatsPerVertex floats each, starting with the position
+    void extend(const float *vertices, int vertexCount, int floatsPerVertex) {
+        for (int i = 0; i < vertexCount; i++) {
+            const double point[3] = {vertices[i * floatsPerVertex], vertices[i * floatsPerVertex + 1], vertices[i * floatsPerVertex + 2]};
+            extend(point);
+        }
+    }
+
+    void extend(const BoundingBox &other) {
+        if (other.isEmpty()) return;
+        extend(other.minima);
+        extend(other.maxima);
+    }
+
+    double center(int axis) const {
+        return (minima[axis] + maxima[axis]) / 2;
+    }
+
+    double volume() const {
+        if (isEmpty()) return 0;
+        return (maxima[0] - minima[0]) * (maxima[1] - minima[1]) * (maxima[2] - minima[2]);
+    }
+
+    bool contains(const double *point, double tolerance) const {
+        for (int i = 0; i < 3; i++) {
+            if (point[i] < minima[i] - tolerance || point[i] > maxima[i] + tolerance) return false;
+        }
+        return true;
+    }
+};
+
+// Indexed triangle mesh. vertices holds the position and the normal of each vertex (6 floats per vertex).
+struct TriangleMesh {
+    QVector<float> vertices;
+    QVector<unsigned int> indices;
+
+    bool isEmpty() const {
+        return indices.isEmpty();
+    }
+
+    BoundingBox boundingBox() const {
+        BoundingBox boundingBox;
+        boundingBox.extend(vertices.constData(), vertices.size() / 6, 6);
+        return boundingBox;
+    }
+};
+
 const double * getLeafMatrix(BRLCAD::Combination::TreeNode& node, const QString& name);
+// Same for a tree that is only read, such as the tree of a cached object state
+const double * getLeafMatrix(const BRLCAD::Combination::ConstTreeNode& node, const QString& name);
 void setLeafMatrix(BRLCAD::Combination::TreeNode& node, const QString& name, double * matrix);
+// BRL-CAD matrices are row major
+QMatrix4x4 toQMatrix4x4(const double * matrix);
+// Finds the first leaf called name. The leaf can then be edited in place for as long as the tree is not restructured.
+bool findLeaf(BRLCAD::Combination::TreeNode& node, const QString& name, BRLCAD::Combination::TreeNode& leaf);
 
 
 class BRLCADObjectCallback : public BRLCAD::Database::ObjectCallback {
@@ -52,7 +123,19 @@ private:
     std::function<void(BRLCAD::Object&)> func;
 };
 
-inline void getBRLCADObject(BRLCAD::MemoryDatabase *database, const QString& objectName,const std::function<void(BRLCAD::Object&)>& func){
+class BRLCADConstObjectCallback : public BRLCAD::ConstDatabase::ObjectCallback {
+public:
+
+    inline explicit BRLCADConstObjectCallback(std::function<void(const BRLCAD::Object&)> func): func(std::move(func)){}
+    inline void operator()(const BRLCAD::Object& object) override {
+        func(object);
+    }
+
+private:
+    std::function<void(const BRLCAD::Object&)> func;
+};
+
+inline void getBRLCADObject(BRLCAD::Database *database, const QString& objectName,const std::function<void(BRLCAD::Object&)>& func){
     BRLCADObjectCallback callback(func);
     database->Get(objectName.toUtf8(), callback);
 }
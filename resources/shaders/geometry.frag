@@ -0,0 +1,19 @@
+#version 330 core
+
+uniform vec4 color;
+uniform bool shaded;    // true for lit triangles. Lines, points and flat colors are drawn in color as is
+
+in vec3 viewNormal;
+
+out vec4 fragmentColor;
+
+void main() {
+    if (!shaded || length(viewNormal) == 0.0) {
+        fragmentColor = color;
+        return;
+    }
+
+    // headlight: ambient plus diffuse from the direction of the viewer, same factors as the material in setFGColor
+    float diffuse = abs(normalize(viewNormal).z);
+    fragmentColor = vec4(color.rgb * (0.2 + 0.6 * diffuse), color.a);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+
+uniform mat4 modelViewMatrix;
+uniform mat4 projectionMatrix;
+
+out vec3 viewNormal;
+
+void main() {
+    viewNormal = mat3(modelViewMatrix) * normal;
+    gl_Position = projectionMatrix * modelViewMatrix * vec4(position, 1.0);
+}
@@ -0,0 +1,25 @@
+#version 120
+
+uniform vec3 lineColor;
+uniform float alpha;
+uniform float spacing;          // gap between minor lines. Major lines are 10 times further apart
+uniform float lodFraction;      // minor lines fade out as this approaches 1 and the next level takes over
+uniform vec2 center;
+uniform float fadeDistance;
+
+varying vec2 planePosition;
+
+// 1 on a line of the grid with the given spacing, 0 more than a pixel away from it
+float gridLine(float lineSpacing) {
+    vec2 coordinate = planePosition / lineSpacing;
+    vec2 distanceInPixels = abs(fract(coordinate - 0.5) - 0.5) / fwidth(coordinate);
+    return 1.0 - min(min(distanceInPixels.x, distanceInPixels.y), 1.0);
+}
+
+void main() {
+    float line = max(gridLine(spacing) * (1.0 - lodFraction), gridLine(spacing * 10.0));
+    float fade = 1.0 - smoothstep(0.5 * fadeDistance, fadeDistance, distance(planePosition, center));
+    float fragmentAlpha = line * fade * alpha;
+    if (fragmentAlpha <= 0.0) discard;
+    gl_FragColor = vec4(lineColor, fragmentAlpha);
+}
@@ -0,0 +1,14 @@
+#version 120
+
+// corner of the unit quad [-1, 1]^2
+attribute vec2 position;
+
+uniform vec2 center;
+uniform float halfExtent;
+
+varying vec2 planePosition;
+
+void main() {
+    planePosition = center + position * halfExtent;
+    gl_Position = gl_ModelViewProjectionMatrix * vec4(planePosition, 0.0, 1.0);
+}
@@ -5,61 +5,325 @@
 #include <Document.h>
 #include<Display.h>
 #include <brlcad/Torus.h>
+#include <brlcad/Combination.h>
+#include <QFileInfo>
+#include <QLineEdit>
+#include "QVBoxWidget.h"
+#include "Globals.h"
+#include "MainWindow.h"
 
 
 Document::Document(const int documentId, const QString *filePath) : documentId(documentId) {
     if (filePath != nullptr) this->filePath = new QString(*filePath);
-    database =  new BRLCAD::MemoryDatabase();
-    if (filePath != nullptr) {
-        if (!database->Load(filePath->toUtf8().data()))
-        {
-            throw std::runtime_error("Failed to open file");
-        }
+
+    BRLCAD::ConstDatabase *database = filePath != nullptr ? openDatabase(*filePath) : new BRLCAD::MemoryDatabase();
+    if (database == nullptr)
+    {
+        throw std::runtime_error("Failed to open file");
     }
 
-    objectTree = new ObjectTree(database);
+    initialize(database, true);
+}
+
+Document::Document(const int documentId, const QString *filePath, BRLCAD::ConstDatabase *database) : documentId(documentId) {
+    if (filePath != nullptr) this->filePath = new QString(*filePath);
+    initialize(database, false);
+}
+
+void Document::initialize(BRLCAD::ConstDatabase *database, bool buildObjectTree) {
+    this->database = database;
+    memoryDatabase = dynamic_cast<BRLCAD::MemoryDatabase *>(database);
+    fileDatabase = dynamic_cast<BRLCAD::FileDatabase *>(database);
+
+    objectTree = new ObjectTree(database, buildObjectTree);
     properties = new Properties(*this);
+    tessellator = new Tessellator(this);
     geometryRenderer = new GeometryRenderer(this);
+    rayPicker = new RayPicker(this);
     objectTreeWidget = new ObjectTreeWidget(this);
+    QLineEdit *objectSearchBox = new QLineEdit();
+    objectSearchBox->setObjectName("objectSearchBox");
+    objectSearchBox->setPlaceholderText("Search objects");
+    objectSearchBox->setClearButtonEnabled(true);
+    QObject::connect(objectSearchBox, &QLineEdit::textChanged, [this](const QString &text) {
+        objectTreeWidget->filter(text);
+    });
+    QVBoxWidget *objectTreePanel = new QVBoxWidget();
+    objectTreePanel->addWidget(objectSearchBox);
+    objectTreePanel->addWidget(objectTreeWidget);
+    this->objectTreePanel = objectTreePanel;
     displayGrid = new DisplayGrid(this);
 
     displayGrid->forceRerenderAllDisplays();
 
     raytraceWidget = new RaytraceView(this);
+    journal = new EditJournal(this, filePath);
+    undoStack = new QUndoStack();
+    undoStack->setUndoLimit(undoLimit);
+
+    previewCommitTimer.setSingleShot(true);
+    previewCommitTimer.setInterval(previewCommitDelay);
+    QObject::connect(&previewCommitTimer, &QTimer::timeout, [this]() {
+        commitPreview();
+    });
+}
+
+// librt maps the file and builds the directory of objects when opening it. The object bodies are only read
+// from the mapping when the tree or the renderer asks for them, while MemoryDatabase copies the whole file.
+BRLCAD::ConstDatabase *Document::openDatabase(const QString &filePath) {
+    if (QFileInfo(filePath).size() > mappedLoadingThreshold) {
+        BRLCAD::FileDatabase *fileDatabase = new BRLCAD::FileDatabase();
+        if (fileDatabase->Load(filePath.toUtf8().data(), BRLCAD::FileDatabase::ReadOnly)) return fileDatabase;
+        delete fileDatabase;
+        return nullptr;
+    }
+
+    BRLCAD::MemoryDatabase *memoryDatabase = new BRLCAD::MemoryDatabase();
+    if (memoryDatabase->Load(filePath.toUtf8().data())) return memoryDatabase;
+    delete memoryDatabase;
+    return nullptr;
+}
+
+void Document::setLoading(bool loading) {
+    this->loading = loading;
+    displayGrid->setEnabled(!loading);
+    objectTreePanel->setEnabled(!loading);
+    properties->setEnabled(!loading);
 }
 
 Document::~Document() {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    delete rayPicker;
+    delete undoStack;
+    delete journal;
+    delete tessellator;
     delete database;
 }
 
+BRLCAD::MemoryDatabase* Document::getWritableDatabase() {
+    if (memoryDatabase == nullptr) loadEditableDatabase();
+    return memoryDatabase;
+}
+
+// The file is read into memory on a worker thread. The document shows the mapped database and takes no input
+// until editableDatabaseLoaded swaps the databases.
+void Document::loadEditableDatabase() {
+    if (editableDatabaseLoad != nullptr || filePath == nullptr) return;
+
+    EditableDatabaseLoader *loader = new EditableDatabaseLoader(*filePath);
+    editableDatabaseLoad = loader->getResult();
+    // previewCommitTimer lives on the GUI thread and goes away with the document
+    QObject::connect(loader, &EditableDatabaseLoader::finished, &previewCommitTimer, [this]() {
+        editableDatabaseLoaded();
+    });
+    setLoading(true);
+    Globals::mainWindow->getStatusBar()->showMessage("Preparing " + QFileInfo(*filePath).fileName() + " for editing...");
+    loader->start();
+}
+
+void Document::editableDatabaseLoaded() {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    BRLCAD::MemoryDatabase *loadedDatabase = editableDatabaseLoad->database;
+    editableDatabaseLoad->database = nullptr;
+    editableDatabaseLoad.reset();
+    setLoading(false);
+
+    const QString fileName = QFileInfo(*filePath).fileName();
+    if (loadedDatabase == nullptr) {
+        // the file was readable when the document was opened, so this is unlikely. The edits that waited are dropped.
+        pendingAddedObjects.clear();
+        pendingObjectStates.clear();
+        objectStates.clear();
+        undoStack->clear();
+        Globals::mainWindow->getStatusBar()->showMessage("Failed to load " + fileName + " for editing",
+                                                         Globals::mainWindow->statusBarShortMessageDuration);
+        return;
+    }
+
+    memoryDatabase = loadedDatabase;
+    database = memoryDatabase;
+    objectTree->setDatabase(database);
+    delete fileDatabase;
+    fileDatabase = nullptr;
+
+    for (const std::shared_ptr<const BRLCAD::Object> &object : pendingAddedObjects) addObject(*object);
+    pendingAddedObjects.clear();
+    if (!pendingObjectStates.isEmpty()) {
+        const QVector<std::shared_ptr<const BRLCAD::Object>> states = pendingObjectStates;
+        pendingObjectStates.clear();
+        applyObjectStates(states);
+    }
+    Globals::mainWindow->getStatusBar()->showMessage(fileName + " is ready for editing",
+                                                     Globals::mainWindow->statusBarShortMessageDuration);
+}
+
+bool Document::addObject(const BRLCAD::Object& object) {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    if (getWritableDatabase() == nullptr) {
+        pendingAddedObjects.append(std::shared_ptr<const BRLCAD::Object>(object.Clone()));
+        return true;
+    }
+    if (!getWritableDatabase()->Add(object)) return false;
+    modifiedObjectNames.insert(object.Name());
+    journal->record(object.Name());
+    tessellator->invalidate(object.Name());
+    return true;
+}
+
 void Document::modifyObject(BRLCAD::Object *newObject) {
-    database->Set(*newObject);
-    QString objectName = newObject->Name();
-    getObjectTree()->traverseSubTree(0,false,[this, objectName]
-    (int objectId){
-        if (getObjectTree()->getNameMap()[objectId] == objectName){
-            geometryRenderer->clearObject(objectId);
+    modifyObjects({newObject});
+}
+
+void Document::modifyObjects(const QVector<BRLCAD::Object *> &newObjects) {
+    QVector<std::shared_ptr<const BRLCAD::Object>> before;
+    QVector<std::shared_ptr<const BRLCAD::Object>> after;
+    QVector<std::shared_ptr<const BRLCAD::Object>> withoutBefore;
+    for (BRLCAD::Object *newObject : newObjects) {
+        std::shared_ptr<const BRLCAD::Object> objectBefore = getObjectState(newObject->Name());
+        std::shared_ptr<const BRLCAD::Object> objectAfter(newObject->Clone());
+        if (objectBefore == nullptr) {
+            withoutBefore.append(objectAfter);
+            continue;
         }
-        return true;
+        before.append(objectBefore);
+        after.append(objectAfter);
     }
-    );
-    geometryRenderer->refreshForVisibilityAndSolidChanges();
-    for (Display * display : displayGrid->getDisplays())display->forceRerenderFrame();
+
+    if (!withoutBefore.isEmpty()) applyObjectStates(withoutBefore);
+    if (!after.isEmpty()) undoStack->push(new ObjectEditCommand(this, before, after));
+}
+
+void Document::previewObject(BRLCAD::Object *newObject) {
+    if (previewedObject != nullptr && previewedObject != newObject) commitPreview();
+    previewedObject = newObject;
+
+    geometryRenderer->setPreviewObject(*newObject);
+    displayGrid->forceRerenderAllDisplays();
+    if (!interactiveEdit) previewCommitTimer.start();
+}
+
+void Document::setInteractiveEdit(bool interactiveEdit) {
+    this->interactiveEdit = interactiveEdit;
+    if (interactiveEdit) previewCommitTimer.stop();
+    else commitPreview();
+}
+
+void Document::commitPreview() {
+    previewCommitTimer.stop();
+    if (previewedObject == nullptr) return;
+
+    BRLCAD::Object *newObject = previewedObject;
+    previewedObject = nullptr;
+    modifyObject(newObject);
+    geometryRenderer->clearPreview();
+}
+
+std::shared_ptr<const BRLCAD::Object> Document::getObjectState(const QString &objectName) {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    if (std::shared_ptr<const BRLCAD::Object> *cachedState = objectStates.object(objectName)) return *cachedState;
+
+    std::shared_ptr<const BRLCAD::Object> state;
+    BRLCADConstObjectCallback callback([&state](const BRLCAD::Object &object) {
+        state.reset(object.Clone());
+    });
+    database->Get(objectName.toUtf8(), callback);
+    if (state != nullptr) objectStates.insert(objectName, new std::shared_ptr<const BRLCAD::Object>(state));
+    return state;
+}
+
+QMatrix4x4 Document::getInstanceMatrix(int objectId) {
+    QMatrix4x4 matrix;
+    const int parentObjectId = objectTree->getParent()[objectId];
+    if (parentObjectId == 0) return matrix;
+
+    const std::shared_ptr<const BRLCAD::Object> parentState = getObjectState(objectTree->getNameMap()[parentObjectId]);
+    const BRLCAD::Combination *combination = dynamic_cast<const BRLCAD::Combination *>(parentState.get());
+    if (combination == nullptr) return matrix;
+    const double *leafMatrix = getLeafMatrix(combination->Tree(), objectTree->getNameMap()[objectId]);
+    if (leafMatrix != nullptr) matrix = toQMatrix4x4(leafMatrix);
+    return matrix;
+}
+
+QMatrix4x4 Document::getPathMatrix(int objectId) {
+    QMatrix4x4 matrix;
+    for (int id = objectId; id != 0 && objectTree->getParent()[id] != 0; id = objectTree->getParent()[id]) {
+        matrix = getInstanceMatrix(id) * matrix;
+    }
+    return matrix;
 }
 
+void Document::setInstanceMatrix(int objectId, const QMatrix4x4 &matrix) {
+    const int parentObjectId = objectTree->getParent()[objectId];
+    if (parentObjectId == 0) return;
+
+    const std::shared_ptr<const BRLCAD::Object> parentState = getObjectState(objectTree->getNameMap()[parentObjectId]);
+    if (dynamic_cast<const BRLCAD::Combination *>(parentState.get()) == nullptr) return;
+    BRLCAD::Combination *combination = dynamic_cast<BRLCAD::Combination *>(parentState->Clone());
+
+    double leafMatrix[16];
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 4; column++) leafMatrix[4 * row + column] = matrix(row, column);
+    }
+    BRLCAD::Combination::TreeNode tree = combination->Tree();
+    setLeafMatrix(tree, objectTree->getNameMap()[objectId], leafMatrix);
+    modifyObject(combination);
+    delete combination;
+}
+
+// Sets all the states first and then goes over the tree and the renderer once for all of them
+void Document::applyObjectStates(const QVector<std::shared_ptr<const BRLCAD::Object>> &states) {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    if (getWritableDatabase() == nullptr) {
+        // applied once the file is in memory. Reads already see the new states.
+        pendingObjectStates += states;
+        for (const std::shared_ptr<const BRLCAD::Object> &state : states) {
+            objectStates.insert(state->Name(), new std::shared_ptr<const BRLCAD::Object>(state));
+        }
+        return;
+    }
+    QSet<QString> objectNames;
+    QVector<const BRLCAD::Combination *> combinations;
+    for (const std::shared_ptr<const BRLCAD::Object> &state : states) {
+        getWritableDatabase()->Set(*state);
+        QString objectName = state->Name();
+        objectStates.insert(objectName, new std::shared_ptr<const BRLCAD::Object>(state));
+        modifiedObjectNames.insert(objectName);
+        journal->record(objectName);
+        tessellator->invalidate(objectName);
+        objectNames.insert(objectName);
+        if (const BRLCAD::Combination *combination = dynamic_cast<const BRLCAD::Combination *>(state.get())) {
+            combinations.append(combination);
+        }
+    }
+    // children added to or removed from combinations are patched into the tree and its views
+    bool treeChanged = false;
+    for (const BRLCAD::Combination *combination : combinations) {
+        const ObjectTree::Delta delta = objectTree->updateChildren(*combination);
+        if (delta.isEmpty()) continue;
+        geometryRenderer->removeObjects(delta.removedObjectIds);
+        objectTreeWidget->applyDelta(delta);
+        treeChanged = true;
+    }
+    if (treeChanged) objectTreeWidget->refreshItemTextColors();
+
+    QVector<int> objectIds;
+    for (const QString &objectName : objectNames) objectIds += objectTree->getObjectIds(objectName);
+    // a combination's color is inherited by its subtree, which is redrawn by clearObjects
+    for (const BRLCAD::Combination *combination : combinations) objectTree->updateColor(*combination);
+    geometryRenderer->clearObjects(objectIds);
+    geometryRenderer->refreshForVisibilityAndSolidChanges();
+    displayGrid->forceRerenderAllDisplays();
+}
 
 void Document::modifyObjectNoSet(int objectId) {
     QString objectName = objectTree->getNameMap()[objectId];
-    getObjectTree()->traverseSubTree(0,false,[this, objectName]
-                                             (int objectId){
-                                         if (getObjectTree()->getNameMap()[objectId] == objectName){
-                                             geometryRenderer->clearObject(objectId);
-                                         }
-                                         return true;
-                                     }
-    );
+    tessellator->invalidate(objectName);
+    objectStates.remove(objectName); // changed in place by the caller
+    modifiedObjectNames.insert(objectName);
+    journal->record(objectName);
+    for (int instanceId : objectTree->getObjectIds(objectName)) geometryRenderer->clearObject(instanceId);
     geometryRenderer->refreshForVisibilityAndSolidChanges();
-    for (Display * display : displayGrid->getDisplays())display->forceRerenderFrame();
+    displayGrid->forceRerenderAllDisplays();
 }
 Display* Document::getDisplay()
 {
@@ -0,0 +1,91 @@
+/*                D O C U M E N T L O A D E R . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file DocumentLoader.cpp */
+
+#include <QThread>
+#include <QStringList>
+#include "DocumentLoader.h"
+#include "Document.h"
+#include "Globals.h"
+
+
+DocumentLoader::DocumentLoader(const QString &filePath) : filePath(filePath), canceled(false) {
+    qRegisterMetaType<BRLCAD::ConstDatabase *>("BRLCAD::ConstDatabase*");
+    qRegisterMetaType<ObjectTree::Fragment *>("ObjectTree::Fragment*");
+}
+
+void DocumentLoader::start() {
+    QThread *thread = new QThread();
+    moveToThread(thread);
+    connect(thread, &QThread::started, this, &DocumentLoader::load);
+    connect(this, &DocumentLoader::finished, thread, &QThread::quit);
+    // deleted on the GUI thread, after the receivers of finished ran, so a loader that finished is not gone
+    // while the GUI still holds on to it
+    connect(thread, &QThread::finished, thread, [this, thread]() {
+        delete this;
+        thread->deleteLater();
+    });
+    thread->start();
+}
+
+void DocumentLoader::wait() {
+    thread()->wait();
+}
+
+void DocumentLoader::cancel() {
+    canceled = true;
+}
+
+void DocumentLoader::load() {
+    BRLCAD::ConstDatabase *database = nullptr;
+    {
+        QMutexLocker librtLocker(&Globals::librtMutex);
+        database = Document::openDatabase(filePath);
+    }
+    if (database == nullptr) {
+        emit failed();
+        emit finished(false);
+        return;
+    }
+    if (canceled) {
+        QMutexLocker librtLocker(&Globals::librtMutex);
+        delete database;
+        librtLocker.unlock();
+        emit finished(true);
+        return;
+    }
+
+    QStringList topObjectNames;
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    for (BRLCAD::ConstDatabase::TopObjectIterator it = database->FirstTopObject(); it.Good(); ++it) {
+        topObjectNames.append(it.Name());
+    }
+    librtLocker.unlock();
+    emit opened(database, topObjectNames.size());
+
+    for (const QString &topObjectName : topObjectNames) {
+        if (canceled) break;
+        ObjectTree::Fragment *fragment = new ObjectTree::Fragment();
+        ObjectTree::buildFragment(database, topObjectName, *fragment);
+        emit fragmentLoaded(fragment);
+    }
+
+    emit finished(canceled);
+}
@@ -0,0 +1,118 @@
+/*                 D O C U M E N T S A V E R . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file DocumentSaver.cpp */
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include <cstdio>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <brlcad/FileDatabase.h>
+#include "DocumentSaver.h"
+#include "Document.h"
+#include "Globals.h"
+#include "Utils.h"
+
+
+DocumentSaver::DocumentSaver(Document *document, const QString &filePath) : filePath(filePath) {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    if (document->getFilePath() != nullptr) baseFilePath = *document->getFilePath();
+
+    objectNames = document->getModifiedObjectNames().values();
+    document->getModifiedObjectNames().clear();
+
+    BRLCADConstObjectCallback callback([this](const BRLCAD::Object &object) {
+        objects.push_back(object.Clone());
+    });
+    for (const QString &objectName : objectNames) {
+        document->getDatabase()->Get(objectName.toUtf8(), callback);
+    }
+}
+
+DocumentSaver::~DocumentSaver() {
+    for (BRLCAD::Object *object : objects) delete object;
+}
+
+void DocumentSaver::start() {
+    QThread *thread = new QThread();
+    moveToThread(thread);
+    connect(thread, &QThread::started, this, &DocumentSaver::save);
+    connect(this, &DocumentSaver::finished, thread, &QThread::quit);
+    connect(thread, &QThread::finished, this, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    thread->start();
+}
+
+// std::rename does not replace an existing file on Windows
+static bool replaceFile(const QString &sourceFilePath, const QString &targetFilePath) {
+#ifdef _WIN32
+    const QString source = QDir::toNativeSeparators(sourceFilePath);
+    const QString target = QDir::toNativeSeparators(targetFilePath);
+    return MoveFileExW(reinterpret_cast<LPCWSTR>(source.utf16()), reinterpret_cast<LPCWSTR>(target.utf16()),
+                       MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(sourceFilePath.toUtf8().data(), targetFilePath.toUtf8().data()) == 0;
+#endif
+}
+
+void DocumentSaver::save() {
+    // in the same directory, so that the rename does not move data between file systems
+    const QFileInfo fileInfo(filePath);
+    const QString temporaryFilePath = fileInfo.absolutePath() + "/." + fileInfo.fileName() + ".saving";
+
+    QFile::remove(temporaryFilePath);
+    if (!write(temporaryFilePath) || !replaceFile(temporaryFilePath, filePath)) {
+        QFile::remove(temporaryFilePath);
+        emit finished(false, objectNames);
+        return;
+    }
+    emit finished(true, objectNames);
+}
+
+bool DocumentSaver::write(const QString &temporaryFilePath) {
+    if (!baseFilePath.isEmpty() && !QFile::copy(baseFilePath, temporaryFilePath)) return false;
+
+    // The lock is taken per librt call, not for the whole write, so the GUI can plot and pick between objects.
+    // It is held again when the function returns, while the database is closed.
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    BRLCAD::FileDatabase database;
+    bool success = database.Load(temporaryFilePath.toUtf8().data(), BRLCAD::FileDatabase::ReadWriteCreate);
+    librtLocker.unlock();
+
+    for (const BRLCAD::Object *object : objects) {
+        if (!success) break;
+        bool exists = false;
+        BRLCADConstObjectCallback callback([&exists](const BRLCAD::Object &) {
+            exists = true;
+        });
+
+        librtLocker.relock();
+        database.Get(object->Name(), callback);
+        success = exists ? database.Set(*object) : database.Add(*object);
+        librtLocker.unlock();
+    }
+
+    librtLocker.relock();
+    return success;
+}
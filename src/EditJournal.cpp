@@ -0,0 +1,253 @@
+/*                   E D I T J O U R N A L . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file EditJournal.cpp */
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+#include "EditJournal.h"
+#include "Document.h"
+#include "Globals.h"
+#include "Utils.h"
+
+
+EditJournalWriter::EditJournalWriter(const QString &directory) : directory(directory) {}
+
+EditJournalWriter::~EditJournalWriter() {
+    close();
+}
+
+bool EditJournalWriter::open() {
+    if (database != nullptr) return true;
+
+    database = new BRLCAD::FileDatabase();
+    if (!database->Load((directory + "/journal.g").toUtf8().data(), BRLCAD::FileDatabase::ReadWriteCreate)) {
+        delete database;
+        database = nullptr;
+        return false;
+    }
+    log.setFileName(directory + "/journal.log");
+    if (!log.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void EditJournalWriter::close() {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    delete database;
+    database = nullptr;
+    log.close();
+}
+
+void EditJournalWriter::write(const QVector<BRLCAD::Object *> &objects) {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    if (open()) {
+        for (const BRLCAD::Object *object : objects) {
+            bool exists = false;
+            BRLCADConstObjectCallback callback([&exists](const BRLCAD::Object &) {
+                exists = true;
+            });
+            database->Get(object->Name(), callback);
+
+            if (exists) database->Set(*object);
+            else if (!database->Add(*object)) continue;
+
+            // the state is written before the line that refers to it
+            log.write("object " + QByteArray(object->Name()) + "\n");
+        }
+        log.flush();
+    }
+
+    for (BRLCAD::Object *object : objects) delete object;
+}
+
+void EditJournalWriter::writeBaseFilePath(const QString &baseFilePath) {
+    if (!open()) return;
+    log.write("file " + baseFilePath.toUtf8() + "\n");
+    log.flush();
+}
+
+void EditJournalWriter::reset(const QString &baseFilePath) {
+    close();
+    QFile::remove(directory + "/journal.g");
+    QFile::remove(directory + "/journal.log");
+    writeBaseFilePath(baseFilePath);
+}
+
+
+EditJournal::EditJournal(Document *document, const QString *baseFilePath) : document(document) {
+    qRegisterMetaType<QVector<BRLCAD::Object *>>("QVector<BRLCAD::Object*>");
+
+    directory = journalsDirectory() + "/" + QString::number(QDateTime::currentMSecsSinceEpoch()) + "-" +
+                QString::number(QCoreApplication::applicationPid()) + "-" + QString::number(document->getDocumentId());
+    if (journalsDirectory().isEmpty() || !QDir().mkpath(directory)) {
+        directory.clear();
+        return;
+    }
+
+    lock = new QLockFile(directory + "/journal.lock");
+    lock->setStaleLockTime(0);
+    lock->tryLock(0);
+
+    EditJournalWriter *writer = new EditJournalWriter(directory);
+    writer->moveToThread(&writerThread);
+    connect(this, &EditJournal::writeRequested, writer, &EditJournalWriter::write);
+    connect(this, &EditJournal::baseFilePathChanged, writer, &EditJournalWriter::writeBaseFilePath);
+    connect(this, &EditJournal::resetRequested, writer, &EditJournalWriter::reset);
+    connect(&writerThread, &QThread::finished, writer, &QObject::deleteLater);
+    writerThread.start();
+    emit resetRequested(baseFilePath != nullptr ? *baseFilePath : QString());
+
+    commitTimer.setSingleShot(true);
+    commitTimer.setInterval(commitInterval);
+    connect(&commitTimer, &QTimer::timeout, this, &EditJournal::commit);
+}
+
+EditJournal::~EditJournal() {
+    if (directory.isEmpty()) return;
+
+    commitTimer.stop();
+    writerThread.quit();
+    writerThread.wait();
+    delete lock;
+    QDir(directory).removeRecursively();
+}
+
+void EditJournal::record(const QString &objectName) {
+    if (directory.isEmpty()) return;
+    pendingObjectNames.insert(objectName);
+    if (!commitTimer.isActive()) commitTimer.start();
+}
+
+void EditJournal::saved(const QString &baseFilePath, bool hasUnsavedEdits) {
+    if (directory.isEmpty()) return;
+    if (hasUnsavedEdits) {
+        // the saved states in the journal are the same as in the new base file. Replaying them is harmless.
+        emit baseFilePathChanged(baseFilePath);
+        return;
+    }
+    commitTimer.stop();
+    pendingObjectNames.clear();
+    emit resetRequested(baseFilePath);
+}
+
+void EditJournal::commit() {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    QVector<BRLCAD::Object *> objects;
+    BRLCADConstObjectCallback callback([&objects](const BRLCAD::Object &object) {
+        objects.append(object.Clone());
+    });
+    for (const QString &objectName : pendingObjectNames) {
+        document->getDatabase()->Get(objectName.toUtf8(), callback);
+    }
+    pendingObjectNames.clear();
+
+    emit writeRequested(objects);
+}
+
+QString EditJournal::journalsDirectory() {
+    const QString dataLocation = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation);
+    if (dataLocation.isEmpty()) return QString();
+    return dataLocation + "/BRLCAD/arbalest/journal";
+}
+
+QStringList EditJournal::orphanedJournals() {
+    QStringList orphanedJournals;
+    if (journalsDirectory().isEmpty()) return orphanedJournals;
+
+    QDir journals(journalsDirectory());
+    for (const QString &name : journals.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        const QString directory = journals.filePath(name);
+        QLockFile lock(directory + "/journal.lock");
+        lock.setStaleLockTime(0);
+        // fails while the document is open in a running arbalest. Succeeds if the lock was left by a dead process.
+        if (!lock.tryLock(0)) continue;
+        lock.unlock();
+        orphanedJournals.append(directory);
+    }
+    return orphanedJournals;
+}
+
+bool EditJournal::read(const QString &directory, QString &baseFilePath, QStringList &objectNames) {
+    QFile log(directory + "/journal.log");
+    if (!log.open(QIODevice::ReadOnly)) return false;
+
+    while (!log.atEnd()) {
+        QString line = QString::fromUtf8(log.readLine());
+        if (!line.endsWith('\n')) break; // cut short by the crash
+        line.chop(1);
+
+        if (line.startsWith("file ")) {
+            baseFilePath = line.mid(5);
+        }
+        else if (line.startsWith("object ")) {
+            const QString objectName = line.mid(7);
+            if (!objectNames.contains(objectName)) objectNames.append(objectName);
+        }
+    }
+    return true;
+}
+
+bool EditJournal::replay(const QString &directory, Document *document) {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    QString baseFilePath;
+    QStringList objectNames;
+    if (!read(directory, baseFilePath, objectNames)) return false;
+
+    BRLCAD::FileDatabase journalDatabase;
+    if (!journalDatabase.Load((directory + "/journal.g").toUtf8().data(), BRLCAD::FileDatabase::ReadOnly)) return false;
+
+    for (const QString &objectName : objectNames) {
+        BRLCAD::Object *object = nullptr;
+        BRLCADConstObjectCallback journalCallback([&object](const BRLCAD::Object &journalObject) {
+            object = journalObject.Clone();
+        });
+        journalDatabase.Get(objectName.toUtf8(), journalCallback);
+        if (object == nullptr) continue;
+
+        bool exists = false;
+        BRLCADConstObjectCallback documentCallback([&exists](const BRLCAD::Object &) {
+            exists = true;
+        });
+        document->getDatabase()->Get(objectName.toUtf8(), documentCallback);
+
+        if (exists) {
+            document->modifyObject(object);
+        }
+        else if (document->addObject(*object)) {
+            // objects are only created as top objects
+            const int objectId = document->getObjectTree()->addTopObject(objectName);
+            document->getObjectTreeWidget()->build(objectId);
+        }
+        delete object;
+    }
+
+    document->getObjectTreeWidget()->refreshItemTextColors();
+    document->getGeometryRenderer()->refreshForVisibilityAndSolidChanges();
+    document->getDisplayGrid()->forceRerenderAllDisplays();
+    return true;
+}
+
+void EditJournal::remove(const QString &directory) {
+    QDir(directory).removeRecursively();
+}
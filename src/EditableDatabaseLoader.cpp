@@ -0,0 +1,57 @@
+/*     E D I T A B L E D A T A B A S E L O A D E R . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file EditableDatabaseLoader.cpp */
+
+#include <QThread>
+#include "EditableDatabaseLoader.h"
+#include "Globals.h"
+
+
+EditableDatabaseLoader::Result::~Result() {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    delete database;
+}
+
+EditableDatabaseLoader::EditableDatabaseLoader(const QString &filePath)
+        : filePath(filePath), result(std::make_shared<Result>()) {}
+
+void EditableDatabaseLoader::start() {
+    QThread *thread = new QThread();
+    moveToThread(thread);
+    connect(thread, &QThread::started, this, &EditableDatabaseLoader::load);
+    connect(this, &EditableDatabaseLoader::finished, thread, &QThread::quit);
+    connect(thread, &QThread::finished, this, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    thread->start();
+}
+
+void EditableDatabaseLoader::load() {
+    BRLCAD::MemoryDatabase *database = new BRLCAD::MemoryDatabase();
+    {
+        QMutexLocker librtLocker(&Globals::librtMutex);
+        if (database->Load(filePath.toUtf8().data())) {
+            result->database = database;
+        }
+        else {
+            delete database;
+        }
+    }
+    emit finished();
+}
@@ -3,4 +3,6 @@
 
 QSSPreprocessor *Globals::theme;
 
-MainWindow *Globals::mainWindow;
\ No newline at end of file
+MainWindow *Globals::mainWindow;
+
+QMutex Globals::librtMutex(QMutex::Recursive);
\ No newline at end of file
@@ -0,0 +1,59 @@
+/*             O B J E C T E D I T C O M M A N D . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file ObjectEditCommand.cpp */
+
+#include "ObjectEditCommand.h"
+#include "Document.h"
+
+
+ObjectEditCommand::ObjectEditCommand(Document *document, QVector<std::shared_ptr<const BRLCAD::Object>> before,
+                                     QVector<std::shared_ptr<const BRLCAD::Object>> after)
+        : document(document), before(std::move(before)), after(std::move(after)) {
+    for (const std::shared_ptr<const BRLCAD::Object> &state : this->after) objectNames << state->Name();
+    if (objectNames.size() == 1) setText("edit " + objectNames[0]);
+    else setText("edit " + QString::number(objectNames.size()) + " objects");
+    lastEditTimer.start();
+}
+
+void ObjectEditCommand::undo() {
+    document->applyObjectStates(before);
+    document->getProperties()->refresh();
+}
+
+void ObjectEditCommand::redo() {
+    document->applyObjectStates(after);
+
+    // the first redo is the edit itself. The properties panel already shows it and may be in the middle of typing.
+    if (firstRedo) firstRedo = false;
+    else document->getProperties()->refresh();
+}
+
+int ObjectEditCommand::id() const {
+    return 1;
+}
+
+bool ObjectEditCommand::mergeWith(const QUndoCommand *other) {
+    const ObjectEditCommand *command = static_cast<const ObjectEditCommand *>(other);
+    if (command->objectNames != objectNames || lastEditTimer.elapsed() > mergeInterval) return false;
+
+    after = command->after;
+    lastEditTimer.start();
+    return true;
+}
@@ -26,29 +26,27 @@
   *
   */
 
+#include <algorithm>
+#include <iterator>
 #include <brlcad/Combination.h>
 #include "ObjectTree.h"
 #include <QStandardItemModel>
 #include "MemoryDatabase.h"
+#include "Globals.h"
 
 
 void ObjectTree::ObjectTreeCallback::operator()(const BRLCAD::Object& object)
 {
-	objectId = ++objectTree->lastAllocatedId;
-    objectTree->getChildren()[objectId] = QVector<int>();
-	objectTree->objectIdParentObjectIdMap[objectId] = parentObjectId;
-	childrenNames = &objectTree->getChildren()[objectId];
-
-	objectTree->getFullPathMap()[objectId] = currentObjectPath;
-
-
 	if (const BRLCAD::Combination* combination = dynamic_cast<const BRLCAD::Combination*>(&object)) {
-
+		if (combination->HasColor()) {
+			fragment.nodes[nodeIndex].color = {static_cast<float>(combination->Red()), static_cast<float>(combination->Green()),
+											   static_cast<float>(combination->Blue()), true};
+		}
 		traverseSubTree(combination->Tree());
 	}
 	else
 	{
-		objectTree->getDrawableObjectIds().insert(objectId);
+		fragment.nodes[nodeIndex].drawable = true;
 	}
 }
 
@@ -69,36 +67,162 @@ void ObjectTree::ObjectTreeCallback::traverseSubTree(const BRLCAD::Combination::
 		break;
 
 	case BRLCAD::Combination::ConstTreeNode::Leaf:
-        objectTree->getChildren()[objectId].append(objectTree->lastAllocatedId + 1);
-		QString childName = QString(node.Name());
-		objectTree->getNameMap()[objectTree->lastAllocatedId + 1] = childName;
-		ObjectTreeCallback callback(objectTree, childName, objectId);
-		objectTree->getDatabase()->Get(node.Name(), callback);
+		fragment.nodes.append({QString(node.Name()), nodeIndex, false, {1, 1, 1, false}});
+		ObjectTreeCallback callback(database, fragment, fragment.nodes.size() - 1);
+		database->Get(node.Name(), callback);
 	}
 }
 
 
-int ObjectTree::addTopObject(QString name) {
-	QVector<int>* childrenNames = &getChildren()[0];
-    int topObjectId = lastAllocatedId + 1;
-	childrenNames->append(topObjectId);
-	getNameMap()[topObjectId] = name;
-	ObjectTreeCallback callback(this, name, 0);
-	database->Get(name.toUtf8(), callback);
-    buildColorMap(topObjectId);
-	return topObjectId;
+void ObjectTree::buildFragment(BRLCAD::ConstDatabase* database, const QString& topObjectName, Fragment& fragment) {
+	QMutexLocker librtLocker(&Globals::librtMutex);
+	fragment.nodes.append({topObjectName, -1, false, {1, 1, 1, false}});
+	ObjectTreeCallback callback(database, fragment, 0);
+	database->Get(topObjectName.toUtf8(), callback);
 }
 
+int ObjectTree::allocateObjectId() {
+	if (freeObjectIds.isEmpty()) return ++lastAllocatedId;
+	const int objectId = freeObjectIds.last();
+	freeObjectIds.removeLast();
+	return objectId;
+}
 
-ObjectTree::ObjectTree(BRLCAD::MemoryDatabase* database) : database(database) {
-	BRLCAD::ConstDatabase::TopObjectIterator it = database->FirstTopObject();
+int ObjectTree::addFragment(const Fragment& fragment, const int parentObjectId) {
+	QVector<int> objectIds(fragment.nodes.size());
+	// objects added under a combination are shown if the combination is
+	const VisibilityState visibility = parentObjectId != 0 && objectIdVisibilityStateMap.value(parentObjectId) == FullyVisible ?
+									   FullyVisible : Invisible;
+
+	for (int i = 0; i < fragment.nodes.size(); i++) {
+		const Fragment::Node& node = fragment.nodes[i];
+		const int objectId = allocateObjectId();
+		const int nodeParentObjectId = node.parentIndex == -1 ? parentObjectId : objectIds[node.parentIndex];
+		objectIds[i] = objectId;
+
+		objectIdChildrenObjectIdsMap[nodeParentObjectId].append(objectId);
+		objectIdChildrenObjectIdsMap[objectId] = QVector<int>();
+		objectIdParentObjectIdMap[objectId] = nodeParentObjectId;
+		QHash<QString, QVector<int>>::iterator instances = nameObjectIdsMap.find(node.name);
+		if (instances == nameObjectIdsMap.end()) {
+			instances = nameObjectIdsMap.insert(node.name, QVector<int>());
+			indexName(instances.key());
+		}
+		instances->append(objectId);
+		nameMap[objectId] = instances.key();
+		fullPathMap[objectId] = fullPathMap[nodeParentObjectId] + "/" + node.name;
+		colorMap[objectId] = node.color.hasColor ? node.color : colorMap[nodeParentObjectId];
+		if (!node.drawable) combinationColorMap[instances.key()] = node.color;
+		objectIdVisibilityStateMap[objectId] = visibility;
+		if (node.drawable) drawableObjectIds.insert(objectId);
+	}
+
+	if (parentObjectId != 0) invalidateBoundingBoxes(parentObjectId);
+	return objectIds.isEmpty() ? -1 : objectIds[0];
+}
+
+// Leaves the id in the children list of the parent. The caller replaces that list.
+void ObjectTree::removeSubTree(const int objectId, QVector<int>& removedObjectIds) {
+	removedObjectIds.append(objectId);
+	for (int childObjectId : objectIdChildrenObjectIdsMap[objectId]) removeSubTree(childObjectId, removedObjectIds);
+
+	QHash<QString, QVector<int>>::iterator instances = nameObjectIdsMap.find(nameMap[objectId]);
+	if (instances != nameObjectIdsMap.end()) {
+		instances->removeOne(objectId);
+		if (instances->isEmpty()) {
+			combinationColorMap.remove(instances.key());
+			nameObjectIdsMap.erase(instances);
+		}
+	}
+	objectIdChildrenObjectIdsMap.remove(objectId);
+	objectIdParentObjectIdMap.remove(objectId);
+	nameMap.remove(objectId);
+	fullPathMap.remove(objectId);
+	colorMap.remove(objectId);
+	objectIdVisibilityStateMap.remove(objectId);
+	drawableObjectIds.remove(objectId);
+	solidBoundingBoxMap.remove(objectId);
+	boundingBoxCache.remove(objectId);
+}
+
+static void getLeafNames(const BRLCAD::Combination::ConstTreeNode& node, QStringList& leafNames) {
+	switch (node.Operation())
+	{
+	case BRLCAD::Combination::ConstTreeNode::Union:
+	case BRLCAD::Combination::ConstTreeNode::Intersection:
+	case BRLCAD::Combination::ConstTreeNode::Subtraction:
+	case BRLCAD::Combination::ConstTreeNode::ExclusiveOr:
+		getLeafNames(node.LeftOperand(), leafNames);
+		getLeafNames(node.RightOperand(), leafNames);
+		break;
+
+	case BRLCAD::Combination::ConstTreeNode::Not:
+		getLeafNames(node.Operand(), leafNames);
+		break;
+
+	case BRLCAD::Combination::ConstTreeNode::Leaf:
+		leafNames.append(QString(node.Name()));
+	}
+}
+
+ObjectTree::Delta ObjectTree::updateChildren(const BRLCAD::Combination& combination) {
+	Delta delta;
+	QStringList childNames;
+	getLeafNames(combination.Tree(), childNames);
+	// subtrees of new children, read once for all instances
+	QHash<QString, Fragment> fragments;
+
+	for (int objectId : getObjectIds(combination.Name())) {
+		const QVector<int> oldChildObjectIds = objectIdChildrenObjectIdsMap[objectId];
+		QStringList oldChildNames;
+		for (int childObjectId : oldChildObjectIds) oldChildNames.append(nameMap[childObjectId]);
+		if (oldChildNames == childNames) continue;
+
+		// a child keeps its id if it is still there, matched by name in order of appearance
+		QHash<QString, QVector<int>> oldChildObjectIdsByName;
+		for (int childObjectId : oldChildObjectIds) oldChildObjectIdsByName[nameMap[childObjectId]].append(childObjectId);
+
+		QVector<int> childObjectIds;
+		for (const QString& childName : childNames) {
+			QVector<int>& sameNameObjectIds = oldChildObjectIdsByName[childName];
+			if (!sameNameObjectIds.isEmpty()) {
+				childObjectIds.append(sameNameObjectIds.takeFirst());
+				continue;
+			}
+			if (!fragments.contains(childName)) buildFragment(database, childName, fragments[childName]);
+			const int childObjectId = addFragment(fragments[childName], objectId);
+			childObjectIds.append(childObjectId);
+			delta.addedObjectIds.append(childObjectId);
+		}
+		for (const QVector<int>& removedChildObjectIds : oldChildObjectIdsByName) {
+			for (int childObjectId : removedChildObjectIds) removeSubTree(childObjectId, delta.removedObjectIds);
+		}
+
+		objectIdChildrenObjectIdsMap[objectId] = childObjectIds;
+		invalidateBoundingBoxes(objectId);
+		delta.changedObjectIds.append(objectId);
+	}
+
+	freeObjectIds += delta.removedObjectIds;
+	return delta;
+}
+
+int ObjectTree::addTopObject(QString name) {
+	Fragment fragment;
+	buildFragment(database, name, fragment);
+	return addFragment(fragment);
+}
 
+
+ObjectTree::ObjectTree(BRLCAD::ConstDatabase* database, bool addTopObjects) : database(database) {
     objectIdChildrenObjectIdsMap[0] = QVector<int>(); // objectId of root is 0
     objectIdParentObjectIdMap[0] = -1;
 	nameMap[0] = "";
 	colorMap[0] = {1,1,1,false };
 
+	if (!addTopObjects) return;
 
+	BRLCAD::ConstDatabase::TopObjectIterator it = database->FirstTopObject();
 	while (it.Good()) {
 		QString childName = it.Name();
 		addTopObject(childName);
@@ -107,6 +231,107 @@ ObjectTree::ObjectTree(BRLCAD::MemoryDatabase* database) : database(database) {
 
 }
 
+static quint64 trigram(const QString& lowerCaseText, const int position)
+{
+	return (static_cast<quint64>(lowerCaseText[position].unicode()) << 32) |
+		   (static_cast<quint64>(lowerCaseText[position + 1].unicode()) << 16) |
+		   static_cast<quint64>(lowerCaseText[position + 2].unicode());
+}
+
+void ObjectTree::indexName(const QString& name)
+{
+	if (indexedNameIndexMap.contains(name)) return;
+	const int nameIndex = indexedNames.size();
+	indexedNames.append(name);
+	indexedNameIndexMap[name] = nameIndex;
+
+	const QString lowerCaseName = name.toLower();
+	for (int i = 0; i + 2 < lowerCaseName.size(); i++) {
+		QVector<int>& nameIndices = trigramNameIndicesMap[trigram(lowerCaseName, i)];
+		if (nameIndices.isEmpty() || nameIndices.last() != nameIndex) nameIndices.append(nameIndex);
+	}
+}
+
+QVector<int> ObjectTree::findObjects(const QString& text) const
+{
+	QVector<int> objectIds;
+	if (text.isEmpty()) return objectIds;
+
+	// the candidates are the names having every trigram of text, found by intersecting the sorted lists of names of
+	// its trigrams from the shortest one. Texts shorter than a trigram check every name.
+	const QString lowerCaseText = text.toLower();
+	QVector<const QVector<int>*> trigramNameIndices;
+	for (int i = 0; i + 2 < lowerCaseText.size(); i++) {
+		const QHash<quint64, QVector<int>>::const_iterator nameIndices = trigramNameIndicesMap.constFind(trigram(lowerCaseText, i));
+		if (nameIndices == trigramNameIndicesMap.constEnd()) return objectIds;
+		trigramNameIndices.append(&nameIndices.value());
+	}
+	std::sort(trigramNameIndices.begin(), trigramNameIndices.end(), [](const QVector<int>* a, const QVector<int>* b) {
+		return a->size() < b->size();
+	});
+
+	QVector<int> candidates;
+	if (!trigramNameIndices.isEmpty()) candidates = *trigramNameIndices[0];
+	for (int i = 1; i < trigramNameIndices.size() && !candidates.isEmpty(); i++) {
+		QVector<int> intersection;
+		std::set_intersection(candidates.constBegin(), candidates.constEnd(), trigramNameIndices[i]->constBegin(), trigramNameIndices[i]->constEnd(),
+							  std::back_inserter(intersection));
+		candidates.swap(intersection);
+	}
+
+	const auto addMatches = [this, &objectIds, &text](const QString& name) {
+		if (name.contains(text, Qt::CaseInsensitive)) objectIds += nameObjectIdsMap.value(name);
+	};
+	if (trigramNameIndices.isEmpty()) {
+		for (const QString& name : indexedNames) addMatches(name);
+	}
+	else {
+		for (int nameIndex : candidates) addMatches(indexedNames[nameIndex]);
+	}
+	return objectIds;
+}
+
+void ObjectTree::setSolidBoundingBox(const int objectId, const BoundingBox& boundingBox)
+{
+	solidBoundingBoxMap[objectId] = boundingBox;
+	invalidateBoundingBoxes(objectIdParentObjectIdMap.value(objectId, -1));
+}
+
+void ObjectTree::removeSolidBoundingBox(const int objectId)
+{
+	if (solidBoundingBoxMap.remove(objectId) == 0) return;
+	invalidateBoundingBoxes(objectIdParentObjectIdMap.value(objectId, -1));
+}
+
+bool ObjectTree::getBoundingBox(const int objectId, BoundingBox& boundingBox)
+{
+	if (drawableObjectIds.contains(objectId)) {
+		const QHash<int, BoundingBox>::const_iterator solidBoundingBox = solidBoundingBoxMap.constFind(objectId);
+		if (solidBoundingBox == solidBoundingBoxMap.constEnd()) return false;
+		boundingBox.extend(*solidBoundingBox);
+		return true;
+	}
+
+	QHash<int, SubTreeBoundingBox>::const_iterator cached = boundingBoxCache.constFind(objectId);
+	if (cached == boundingBoxCache.constEnd()) {
+		SubTreeBoundingBox subTreeBoundingBox = {BoundingBox(), true};
+		for (int childObjectId : objectIdChildrenObjectIdsMap.value(objectId)) {
+			subTreeBoundingBox.complete = getBoundingBox(childObjectId, subTreeBoundingBox.boundingBox) && subTreeBoundingBox.complete;
+		}
+		cached = boundingBoxCache.insert(objectId, subTreeBoundingBox);
+	}
+	boundingBox.extend(cached->boundingBox);
+	return cached->complete;
+}
+
+// Drops the cached boxes of objectId and its ancestors
+void ObjectTree::invalidateBoundingBoxes(const int objectId)
+{
+	for (int id = objectId; id > 0; id = objectIdParentObjectIdMap.value(id, -1)) {
+		if (boundingBoxCache.remove(id) == 0) break;
+	}
+}
+
 void ObjectTree::traverseSubTree(const int rootOfSubTreeId, bool traverseRoot, const std::function<bool(int)>& callback)
 {
 	if(traverseRoot) callback(rootOfSubTreeId);
@@ -170,20 +395,28 @@ void ObjectTree::changeVisibilityState(int objectId, bool visible) {
 }
 
 void ObjectTree::buildColorMap(int rootObjectId) {
-	traverseSubTree(rootObjectId,true,[&](int objectId){
+	traverseSubTree(rootObjectId,true,[this](int objectId){
 		if(objectId==0)return true;
-		const QString objectName = fullPathMap[objectId];
-		const QByteArray &name = objectName.toUtf8();
-		BRLCAD::Object *object = database->Get(name);
-		colorMap[objectId] = ColorInfo(colorMap[objectIdParentObjectIdMap[objectId]]);
-		if(const BRLCAD::Combination* combination = dynamic_cast<const BRLCAD::Combination*>(object)) {
-			if (combination->HasColor()) {
-				colorMap[objectId].red = combination->Red();
-				colorMap[objectId].green = combination->Green();
-				colorMap[objectId].blue = combination->Blue();
-				colorMap[objectId].hasColor = true;
-			}
-		}
+		const ColorInfo color = combinationColorMap.value(nameMap[objectId]);
+		colorMap[objectId] = color.hasColor ? color : colorMap[objectIdParentObjectIdMap[objectId]];
 		return true;
 	});
 }
+
+void ObjectTree::updateColor(const BRLCAD::Combination& combination) {
+	ColorInfo color = {1, 1, 1, false};
+	if (combination.HasColor()) {
+		color = {static_cast<float>(combination.Red()), static_cast<float>(combination.Green()),
+				 static_cast<float>(combination.Blue()), true};
+	}
+
+	const QString name = combination.Name();
+	const QHash<QString, ColorInfo>::const_iterator cachedColor = combinationColorMap.constFind(name);
+	if (cachedColor != combinationColorMap.constEnd() && cachedColor->hasColor == color.hasColor &&
+		(!color.hasColor || (cachedColor->red == color.red && cachedColor->green == color.green && cachedColor->blue == color.blue))) {
+		return;
+	}
+
+	combinationColorMap[name] = color;
+	for (int objectId : getObjectIds(name)) buildColorMap(objectId);
+}
@@ -22,11 +22,17 @@
 #include "Display.h"
 
 #include <iostream>
+#include <algorithm>
+#include <climits>
 #include <QWidget>
+#include <QSettings>
 #include <OrthographicCamera.h>
 #include <include/Globals.h>
 #include "DisplayManager.h"
 #include "GeometryRenderer.h"
+#include "RayPicker.h"
+#include "TransformGizmo.h"
+#include "MainWindow.h"
 #include "Utils.h"
 
 using namespace std;
@@ -37,26 +43,82 @@ Display::Display(Document*  document):document(document) {
     displayManager = new DisplayManager(*this);
     axesRenderer = new AxesRenderer();
     gridRenderer = new GridRenderer(this);
+    transformGizmo = new TransformGizmo(this, document);
 
     bgColor = Globals::theme->getColor("$Color-GraphicsView");
     displayManager->setBGColor(bgColor.redF(),bgColor.greenF(),bgColor.blueF());
 
-    makeCurrent();
-    update();
+    // needed for hover highlighting
+    setMouseTracking(true);
+
+    // a frame requested while another one is waiting for the swap is rendered right after the swap
+    connect(this, &QOpenGLWidget::frameSwapped, this, [this](){
+        frameInFlight = false;
+        if (interacting) adaptInteractiveQuality(frameTimer.elapsed());
+        if (frameRequested) update();
+    });
+
+    // full quality frame once the camera stops moving
+    interactionEndTimer.setSingleShot(true);
+    interactionEndTimer.setInterval(interactionEndDelay);
+    connect(&interactionEndTimer, &QTimer::timeout, this, [this](){
+        interacting = false;
+        forceRerenderFrame();
+    });
+
+    forceRerenderFrame();
 }
 
 Display::~Display() {
     delete camera;
     delete displayManager;
     delete axesRenderer;
+    delete transformGizmo;
+    makeCurrent();
+    delete gridRenderer;
+    delete idBuffer;
+    doneCurrent();
 }
 
 
+/*
+ * Requests a new frame. Any number of requests between two frames result in a single paintGL, and at most one
+ * frame is rendered per buffer swap (i.e. per vsync), so fast mouse moves do not flood the event loop.
+ * Hidden displays (ex: in single display mode) are not rendered until they are shown again.
+ */
 void Display::forceRerenderFrame() {
-    makeCurrent();
+    frameRequested = true;
+    if (isHidden()) return;
+    // frameSwapped is not emitted if the window could not be composed (ex: minimized), so do not wait forever
+    if (frameInFlight && frameTimer.isValid() && frameTimer.elapsed() < frameSwapTimeout) return;
     update();
 }
 
+// Switches to interactive quality until the camera has not moved for interactionEndDelay
+void Display::startInteraction() {
+    interacting = true;
+    interactionEndTimer.start();
+}
+
+/*
+ * Adjusts how small a solid can be (in pixels) before it is culled during interaction, so that camera motion
+ * keeps up with the target frame time regardless of the size of the model.
+ */
+void Display::adaptInteractiveQuality(qint64 frameTime) {
+    if (frameTime > targetInteractiveFrameTime * 3 / 2) {
+        interactiveMinimumObjectPixels = std::min(interactiveMinimumObjectPixels * 1.5f, maxInteractiveMinimumObjectPixels);
+    }
+    else if (frameTime < targetInteractiveFrameTime) {
+        interactiveMinimumObjectPixels = std::max(interactiveMinimumObjectPixels * .9f, minInteractiveMinimumObjectPixels);
+    }
+}
+
+void Display::showEvent(QShowEvent *event) {
+    QOpenGLWidget::showEvent(event);
+    frameInFlight = false;
+    if (frameRequested) update();
+}
+
 int Display::getW() const {
     return w;
 }
@@ -79,16 +141,25 @@ void Display::resizeGL(const int w, const int h) {
     camera->setWH(w,h);
     this->w = w;
     this->h = h;
+    idBufferUpToDate = false;
 }
 
 void Display::paintGL() {
+    frameRequested = false;
+    frameInFlight = true;
+    frameTimer.start();
+    idBufferUpToDate = false;
     displayManager->drawBegin();
 
     glViewport(0,0,w,h);
     displayManager->loadMatrix(camera->modelViewMatrix().data());
     displayManager->loadPMatrix(camera->projectionMatrix().data());
+    // while the camera moves, solids smaller than a few pixels are not drawn
+    document->getGeometryRenderer()->setMinimumVisibleObjectSize(
+            interacting ? interactiveMinimumObjectPixels * camera->getVerticalSpan() / h : 0);
     document->getGeometryRenderer()->render();
     if(gridEnabled)gridRenderer->render();
+    transformGizmo->render();
 
     glViewport(w*.88,h*.02,w/10,w/10);
     displayManager->loadMatrix(camera->modelViewMatrixNoTranslate().data());
@@ -101,6 +172,11 @@ void Display::paintGL() {
 void Display::mouseMoveEvent(QMouseEvent *event) {
 	const int x = event->x();
 	const int y = event->y();
+
+    if (transformGizmo->isDragging()) {
+        transformGizmo->drag(x, y);
+        return;
+    }
     int globalX = event->globalX();
     int globalY = event->globalY();
 
@@ -119,6 +195,7 @@ void Display::mouseMoveEvent(QMouseEvent *event) {
             camera->processMoveRequest(x- prevMouseX, y - prevMouseY);
         }
 
+        startInteraction();
         forceRerenderFrame();
 
         const QPoint topLeft = mapToGlobal(QPoint(0,0));
@@ -156,23 +233,134 @@ void Display::mouseMoveEvent(QMouseEvent *event) {
         prevMouseX = x;
         prevMouseY = y;
     }
+
+    if (event->buttons() == Qt::NoButton) hoverObject(x, y);
 }
 
 void Display::mousePressEvent(QMouseEvent *event) {
     document->getDisplayGrid()->setActiveDisplay(this);
+    // a press on a handle of the gizmo drags the handle instead of the camera
+    if (event->button() == Qt::LeftButton && transformGizmo->press(event->x(), event->y())) {
+        forceRerenderFrame();
+        return;
+    }
     prevMouseX = event->x();
     prevMouseY = event->y();
+    pressMouseX = event->x();
+    pressMouseY = event->y();
 }
 
 void Display::mouseReleaseEvent(QMouseEvent *event) {
     prevMouseX = -1;
     prevMouseY = -1;
+
+    if (transformGizmo->isDragging()) {
+        if (event->button() == Qt::LeftButton) transformGizmo->release();
+        return;
+    }
+
+    // a left click without dragging selects the object under the cursor
+    if (event->button() == Qt::LeftButton &&
+        abs(event->x() - pressMouseX) + abs(event->y() - pressMouseY) <= clickMaxMouseMovement) {
+        const bool cpuPicking = QSettings("BRLCAD", "arbalest").value("cpuPicking", false).toBool();
+        const int objectId = cpuPicking ?
+                document->getRayPicker()->pick(camera->rayThroughScreenPoint(event->x(), event->y()), true) :
+                pickObject(event->x(), event->y());
+        if (objectId != -1) document->getObjectTreeWidget()->selectObject(objectId);
+    }
+}
+
+/*
+ * Returns the objectId of the solid drawn at (x, y) of the display or -1 if there is none.
+ * The pixels around (x, y) are read back from the object id buffer, so the cost of a pick does not depend on
+ * the size of the scene (apart from re-rendering the id buffer once after the frame changes).
+ */
+int Display::pickObject(int x, int y) {
+    if (x < 0 || y < 0 || x >= w || y >= h) return -1;
+    makeCurrent();
+    if (!idBufferUpToDate) renderIdBuffer();
+
+    // OpenGL's origin is at the bottom left
+    const int left = std::max(0, x - pickRadius);
+    const int bottom = std::max(0, (h - 1 - y) - pickRadius);
+    const int right = std::min(w - 1, x + pickRadius);
+    const int top = std::min(h - 1, (h - 1 - y) + pickRadius);
+    const int width = right - left + 1;
+    const int height = top - bottom + 1;
+
+    QVector<unsigned char> pixels(width * height * 4);
+    idBuffer->bind();
+    glReadPixels(left, bottom, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    idBuffer->release();
+    doneCurrent();
+
+    // wireframes are thin, so take the object closest to the cursor within pickRadius
+    int pickedObjectId = -1;
+    int pickedDistance = INT_MAX;
+    for (int row = 0; row < height; row++) {
+        for (int column = 0; column < width; column++) {
+            const unsigned int objectId = DisplayManager::idFromColor(&pixels[(row * width + column) * 4]);
+            if (objectId == 0) continue;
+            const int dx = left + column - x;
+            const int dy = bottom + row - (h - 1 - y);
+            if (dx * dx + dy * dy < pickedDistance) {
+                pickedDistance = dx * dx + dy * dy;
+                pickedObjectId = objectId;
+            }
+        }
+    }
+    return pickedObjectId;
+}
+
+/*
+ * Highlights the solid under the cursor. This runs on every mouse move, so only the bounding box BVH of RayPicker
+ * is used here; neither the GPU id buffer nor the raytracer is touched.
+ */
+void Display::hoverObject(int x, int y) {
+    GeometryRenderer *geometryRenderer = document->getGeometryRenderer();
+    const int objectId = document->getRayPicker()->pick(camera->rayThroughScreenPoint(x, y), false);
+    if (objectId == geometryRenderer->getHighlightedObjectId()) return;
+
+    geometryRenderer->setHighlightedObjectId(objectId);
+    document->getDisplayGrid()->forceRerenderAllDisplays();
+    if (objectId != -1) {
+        Globals::mainWindow->getStatusBar()->showMessage(document->getObjectTree()->getFullPathMap()[objectId],
+                                                         Globals::mainWindow->statusBarShortMessageDuration);
+    }
+}
+
+void Display::renderIdBuffer() {
+    if (idBuffer == nullptr || idBuffer->size() != QSize(w, h)) {
+        delete idBuffer;
+        idBuffer = new QOpenGLFramebufferObject(w, h, QOpenGLFramebufferObject::Depth);
+    }
+
+    idBuffer->bind();
+    displayManager->saveState();
+
+    glDisable(GL_BLEND);
+    glDisable(GL_DITHER);
+    glDisable(GL_LINE_SMOOTH);
+    glDisable(GL_POINT_SMOOTH);
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0, 0, 0, 0);   // objectId 0 is the root, which is never drawn
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glViewport(0, 0, w, h);
+    displayManager->loadMatrix(camera->modelViewMatrix().data());
+    displayManager->loadPMatrix(camera->projectionMatrix().data());
+    document->getGeometryRenderer()->renderObjectIds(idBufferLineWidth);
+
+    displayManager->restoreState();
+    idBuffer->release();
+    idBufferUpToDate = true;
 }
 
 void Display::wheelEvent(QWheelEvent *event) {
 
     if (event->phase() == Qt::NoScrollPhase || event->phase() == Qt::ScrollUpdate || event->phase() == Qt::ScrollMomentum) {
         camera->processZoomRequest(event->angleDelta().y() / 8);
+        startInteraction();
         forceRerenderFrame();
     }
 }
@@ -181,23 +369,44 @@ void Display::keyPressEvent( QKeyEvent *k ) {
     switch (k->key()) {
         case Qt::Key_Up:
             camera->processMoveRequest(0, keyPressSimulatedMouseMoveDistance);
+            startInteraction();
             forceRerenderFrame();
             break;
         case Qt::Key_Down:
             camera->processMoveRequest(0, -keyPressSimulatedMouseMoveDistance);
+            startInteraction();
             forceRerenderFrame();
             break;
         case Qt::Key_Left:
             camera->processMoveRequest(keyPressSimulatedMouseMoveDistance, 0);
+            startInteraction();
             forceRerenderFrame();
             break;
         case Qt::Key_Right:
             camera->processMoveRequest(-keyPressSimulatedMouseMoveDistance, 0);
+            startInteraction();
+            forceRerenderFrame();
+            break;
+        // gizmo modes, as in most modelers
+        case Qt::Key_W:
+            transformGizmo->setMode(TransformGizmo::Translate);
+            forceRerenderFrame();
+            break;
+        case Qt::Key_E:
+            transformGizmo->setMode(TransformGizmo::Rotate);
+            forceRerenderFrame();
+            break;
+        case Qt::Key_R:
+            transformGizmo->setMode(TransformGizmo::Scale);
             forceRerenderFrame();
             break;
     }
 }
 
+TransformGizmo *Display::getTransformGizmo() const {
+    return transformGizmo;
+}
+
 OrthographicCamera *Display::getCamera() const {
     return camera;
 }
@@ -20,11 +20,28 @@
 /** @file DisplayManager.cpp */
 
 #include <QMatrix4x4>
+#include <algorithm>
+#include <iostream>
 #include "DisplayManager.h"
 
 #define DM_SOLID_LINE 0
 #define DM_DASHED_LINE 1
 
+bool DisplayManager::shadersInitialized = false;
+QOpenGLShaderProgram *DisplayManager::program = nullptr;
+QHash<unsigned int, DisplayManager::Batch *> DisplayManager::batches;
+unsigned int DisplayManager::nextBatchId = 1;
+DisplayManager::Batch *DisplayManager::recordingBatch = nullptr;
+DisplayManager::ShaderState DisplayManager::shaderState;
+QStack<DisplayManager::ShaderState> DisplayManager::savedShaderStates;
+QMatrix4x4 DisplayManager::modelViewMatrix;
+QStack<QMatrix4x4> DisplayManager::savedModelViewMatrices;
+QMatrix4x4 DisplayManager::projectionMatrix;
+int DisplayManager::modelViewMatrixLocation = -1;
+int DisplayManager::projectionMatrixLocation = -1;
+int DisplayManager::colorLocation = -1;
+int DisplayManager::shadedLocation = -1;
+
 DisplayManager::DisplayManager(Display &display) : display(display)
 {
     setFGColor(0,0,0, 1);
@@ -233,17 +250,330 @@ DisplayManager::DrawVListElementCallback::DrawVListElementCallback(const Display
                                                                    DrawVlistVars *vars) :
     displayManager(displayManager), vars(vars) {}
 
+DisplayManager::BatchVListElementCallback::BatchVListElementCallback(Batch *batch) : batch(batch) {}
+
+void DisplayManager::BatchVListElementCallback::addVertex(Batch::Primitive primitive, const double *point, const double *normal) {
+    QVector<float> &vertices = batch->vertices[primitive];
+    for (int i = 0; i < 3; i++) vertices.append(static_cast<float>(point[i]));
+    for (int i = 0; i < 3; i++) vertices.append(static_cast<float>(normal[i]));
+}
+
+bool DisplayManager::BatchVListElementCallback::operator()(BRLCAD::VectorList::Element *element) {
+    const double noNormal[3] = {0, 0, 0};
+    if (!element) return true;
+
+    switch (element->Type()) {
+        case BRLCAD::VectorList::Element::LineMove: {
+            BRLCAD::VectorList::LineMove *e = dynamic_cast<BRLCAD::VectorList::LineMove *> (element);
+            std::copy(e->Point().coordinates, e->Point().coordinates + 3, linePoint);
+            hasLinePoint = true;
+            break;
+        }
+        case BRLCAD::VectorList::Element::LineDraw: {
+            BRLCAD::VectorList::LineDraw *e = dynamic_cast<BRLCAD::VectorList::LineDraw *> (element);
+            if (hasLinePoint) {
+                addVertex(Batch::Lines, linePoint, noNormal);
+                addVertex(Batch::Lines, e->Point().coordinates, noNormal);
+            }
+            std::copy(e->Point().coordinates, e->Point().coordinates + 3, linePoint);
+            hasLinePoint = true;
+            break;
+        }
+        case BRLCAD::VectorList::Element::PolygonStart: {
+            BRLCAD::VectorList::PolygonStart *e = dynamic_cast<BRLCAD::VectorList::PolygonStart *> (element);
+            std::copy(e->Normal().coordinates, e->Normal().coordinates + 3, normal);
+            polygon.clear();
+            break;
+        }
+        case BRLCAD::VectorList::Element::TriangleStart: {
+            BRLCAD::VectorList::TriangleStart *e = dynamic_cast<BRLCAD::VectorList::TriangleStart *> (element);
+            std::copy(e->Normal().coordinates, e->Normal().coordinates + 3, normal);
+            break;
+        }
+        case BRLCAD::VectorList::Element::PolygonVertexNormal: {
+            BRLCAD::VectorList::PolygonVertexNormal *e = dynamic_cast<BRLCAD::VectorList::PolygonVertexNormal *> (element);
+            std::copy(e->Normal().coordinates, e->Normal().coordinates + 3, normal);
+            break;
+        }
+        case BRLCAD::VectorList::Element::TriangleVertexNormal: {
+            BRLCAD::VectorList::TriangleVertexNormal *e = dynamic_cast<BRLCAD::VectorList::TriangleVertexNormal *> (element);
+            std::copy(e->Normal().coordinates, e->Normal().coordinates + 3, normal);
+            break;
+        }
+        case BRLCAD::VectorList::Element::PolygonMove:
+        case BRLCAD::VectorList::Element::PolygonDraw:
+        case BRLCAD::VectorList::Element::PolygonEnd: {
+            const double *point = element->Type() == BRLCAD::VectorList::Element::PolygonMove ?
+                    dynamic_cast<BRLCAD::VectorList::PolygonMove *> (element)->Point().coordinates :
+                    element->Type() == BRLCAD::VectorList::Element::PolygonDraw ?
+                    dynamic_cast<BRLCAD::VectorList::PolygonDraw *> (element)->Point().coordinates :
+                    dynamic_cast<BRLCAD::VectorList::PolygonEnd *> (element)->Point().coordinates;
+            polygon << point[0] << point[1] << point[2] << normal[0] << normal[1] << normal[2];
+
+            // polygons are convex, so they are split into a fan of triangles
+            if (element->Type() == BRLCAD::VectorList::Element::PolygonEnd) {
+                for (int i = 1; i + 1 < polygon.size() / 6; i++) {
+                    addVertex(Batch::Triangles, &polygon[0], &polygon[3]);
+                    addVertex(Batch::Triangles, &polygon[i * 6], &polygon[i * 6 + 3]);
+                    addVertex(Batch::Triangles, &polygon[(i + 1) * 6], &polygon[(i + 1) * 6 + 3]);
+                }
+                polygon.clear();
+            }
+            break;
+        }
+        case BRLCAD::VectorList::Element::TriangleMove: {
+            BRLCAD::VectorList::TriangleMove *e = dynamic_cast<BRLCAD::VectorList::TriangleMove *> (element);
+            addVertex(Batch::Triangles, e->Point().coordinates, normal);
+            break;
+        }
+        case BRLCAD::VectorList::Element::TriangleDraw: {
+            BRLCAD::VectorList::TriangleDraw *e = dynamic_cast<BRLCAD::VectorList::TriangleDraw *> (element);
+            addVertex(Batch::Triangles, e->Point().coordinates, normal);
+            break;
+        }
+        case BRLCAD::VectorList::Element::PointDraw: {
+            BRLCAD::VectorList::PointDraw *e = dynamic_cast<BRLCAD::VectorList::PointDraw *> (element);
+            addVertex(Batch::Points, e->Point().coordinates, noNormal);
+            break;
+        }
+        case BRLCAD::VectorList::Element::LineWidth: {
+            BRLCAD::VectorList::LineWidth *e = dynamic_cast<BRLCAD::VectorList::LineWidth *> (element);
+            if (e->Width() > 0) batch->lineWidth = static_cast<float>(e->Width());
+            break;
+        }
+        case BRLCAD::VectorList::Element::PointSize: {
+            BRLCAD::VectorList::PointSize *e = dynamic_cast<BRLCAD::VectorList::PointSize *> (element);
+            if (e->Size() > 0) batch->pointSize = static_cast<float>(e->Size());
+            break;
+        }
+        default:
+            // ModelSpace and DisplaySpace (used for text) are not supported by the shader path
+            break;
+    }
+    return true;
+}
+
+/*
+ * Builds the shaders on first use. Needs a current OpenGL context.
+ * Returns false if they are not available (ex: OpenGL older than 3.3). Display lists and the fixed function
+ * pipeline are used in that case.
+ */
+bool DisplayManager::useShaders()
+{
+    if (!shadersInitialized) {
+        shadersInitialized = true;
+        program = new QOpenGLShaderProgram();
+        if (!program->addShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/geometry.vert") ||
+            !program->addShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/geometry.frag") ||
+            !program->link()) {
+            std::cerr << "Geometry shaders could not be built. Falling back to the fixed function pipeline." << std::endl
+                      << program->log().toStdString() << std::endl;
+            delete program;
+            program = nullptr;
+            return false;
+        }
+        modelViewMatrixLocation = program->uniformLocation("modelViewMatrix");
+        projectionMatrixLocation = program->uniformLocation("projectionMatrix");
+        colorLocation = program->uniformLocation("color");
+        shadedLocation = program->uniformLocation("shaded");
+    }
+    return program != nullptr;
+}
+
+// Moves the vertices of a recorded batch into a vertex buffer
+void DisplayManager::uploadBatch(Batch *batch)
+{
+    int vertexCount = 0;
+    for (int i = 0; i < Batch::PrimitiveCount; i++) {
+        batch->first[i] = vertexCount;
+        batch->count[i] = batch->vertices[i].size() / 6;
+        vertexCount += batch->count[i];
+    }
+
+    if (vertexCount > 0) {
+        batch->buffer.create();
+        batch->buffer.bind();
+        batch->buffer.allocate(vertexCount * 6 * sizeof(float));
+        for (int i = 0; i < Batch::PrimitiveCount; i++) {
+            if (batch->count[i] == 0) continue;
+            batch->buffer.write(batch->first[i] * 6 * sizeof(float), batch->vertices[i].constData(),
+                                batch->count[i] * 6 * sizeof(float));
+        }
+        batch->buffer.release();
+    }
+
+    for (QVector<float> &vertices : batch->vertices) {
+        vertices.clear();
+        vertices.squeeze();
+    }
+}
+
+// The arrays are handed to OpenGL as they are, so they can point into a memory mapped GeometryCache entry
+void DisplayManager::uploadMesh(Batch *batch, const float *vertices, int vertexCount, const unsigned int *indices, int indexCount)
+{
+    if (indexCount == 0) return;
+    batch->meshBuffer.create();
+    batch->meshBuffer.bind();
+    batch->meshBuffer.allocate(vertices, vertexCount * 6 * sizeof(float));
+    batch->meshBuffer.release();
+    batch->indexBuffer.create();
+    batch->indexBuffer.bind();
+    batch->indexBuffer.allocate(indices, indexCount * sizeof(unsigned int));
+    batch->indexBuffer.release();
+    batch->indexCount = indexCount;
+}
+
+// Draws a batch with the current shader state. All the state is set once for the whole batch.
+void DisplayManager::drawBatch(Batch *batch)
+{
+    if (!batch->buffer.isCreated() && batch->indexCount == 0) return;
+
+    program->bind();
+    program->setUniformValue(modelViewMatrixLocation, modelViewMatrix);
+    program->setUniformValue(projectionMatrixLocation, projectionMatrix);
+    const float *color = shaderState.lightingEnabled ? batch->color : shaderState.flatColor;
+    program->setUniformValue(colorLocation, QVector4D(color[0], color[1], color[2], color[3]));
+    program->enableAttributeArray(0);
+    program->enableAttributeArray(1);
+
+    if (batch->buffer.isCreated()) {
+        batch->buffer.bind();
+        program->setAttributeBuffer(0, GL_FLOAT, 0, 3, 6 * sizeof(float));
+        program->setAttributeBuffer(1, GL_FLOAT, 3 * sizeof(float), 3, 6 * sizeof(float));
+
+        if (batch->lineWidth > 0) glLineWidth(batch->lineWidth);
+        if (batch->pointSize > 0) glPointSize(batch->pointSize);
+
+        const GLenum modes[Batch::PrimitiveCount] = {GL_LINES, GL_TRIANGLES, GL_POINTS};
+        for (int i = 0; i < Batch::PrimitiveCount; i++) {
+            if (batch->count[i] == 0) continue;
+            program->setUniformValue(shadedLocation, shaderState.lightingEnabled && i == Batch::Triangles);
+            glDrawArrays(modes[i], batch->first[i], batch->count[i]);
+        }
+
+        if (batch->lineWidth > 0) glLineWidth(shaderState.lineWidth);
+        if (batch->pointSize > 0) glPointSize(shaderState.pointSize);
+        batch->buffer.release();
+    }
+
+    if (batch->indexCount > 0) {
+        batch->meshBuffer.bind();
+        batch->indexBuffer.bind();
+        program->setAttributeBuffer(0, GL_FLOAT, 0, 3, 6 * sizeof(float));
+        program->setAttributeBuffer(1, GL_FLOAT, 3 * sizeof(float), 3, 6 * sizeof(float));
+        program->setUniformValue(shadedLocation, shaderState.lightingEnabled);
+        glDrawElements(GL_TRIANGLES, batch->indexCount, GL_UNSIGNED_INT, nullptr);
+        batch->indexBuffer.release();
+        batch->meshBuffer.release();
+    }
+
+    program->disableAttributeArray(0);
+    program->disableAttributeArray(1);
+    program->release();
+}
+
+/*
+ * Draws an indexed triangle mesh with smooth normals (shaded display mode), in the current foreground color.
+ * Like drawVList this can be recorded into a display list.
+ */
+void DisplayManager::drawMesh(const TriangleMesh &mesh)
+{
+    drawMesh(mesh.vertices.constData(), mesh.vertices.size() / 6, mesh.indices.constData(), mesh.indices.size());
+}
+
+// vertices holds the position and normal of each vertex (6 floats per vertex)
+void DisplayManager::drawMesh(const float *vertices, int vertexCount, const unsigned int *indices, int indexCount)
+{
+    if (recordingBatch != nullptr) {
+        uploadMesh(recordingBatch, vertices, vertexCount, indices, indexCount);
+        return;
+    }
+    if (useShaders()) {
+        Batch batch;
+        std::copy(wireColor, wireColor + 4, batch.color);
+        uploadMesh(&batch, vertices, vertexCount, indices, indexCount);
+        drawBatch(&batch);
+        batch.meshBuffer.destroy();
+        batch.indexBuffer.destroy();
+        return;
+    }
+
+    const float black[4] = {0.0, 0.0, 0.0, 0.0};
+    if (dmLight) {
+        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, black);
+        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, ambientColor);
+        glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specularColor);
+        glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, diffuseColor);
+    }
+    glBegin(GL_TRIANGLES);
+    for (int i = 0; i < indexCount; i++) {
+        glNormal3fv(&vertices[indices[i] * 6 + 3]);
+        glVertex3fv(&vertices[indices[i] * 6]);
+    }
+    glEnd();
+}
+
+/*
+ * Draws line segments in the current foreground color. Each pair of points (3 floats each) is a segment.
+ * Like drawVList this can be recorded into a display list.
+ */
+void DisplayManager::drawLines(const float *points, int pointCount)
+{
+    if (recordingBatch != nullptr || useShaders()) {
+        Batch temporaryBatch;
+        Batch *batch = recordingBatch != nullptr ? recordingBatch : &temporaryBatch;
+        QVector<float> &vertices = batch->vertices[Batch::Lines];
+        vertices.reserve(vertices.size() + pointCount * 6);
+        for (int i = 0; i < pointCount; i++) {
+            vertices << points[i * 3] << points[i * 3 + 1] << points[i * 3 + 2] << 0 << 0 << 0;
+        }
+        if (batch == &temporaryBatch) {
+            std::copy(wireColor, wireColor + 4, temporaryBatch.color);
+            uploadBatch(&temporaryBatch);
+            drawBatch(&temporaryBatch);
+            temporaryBatch.buffer.destroy();
+        }
+        return;
+    }
+
+    const float black[4] = {0.0, 0.0, 0.0, 0.0};
+    if (dmLight) {
+        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, wireColor);
+        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, black);
+        glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, black);
+        glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, black);
+    }
+    glBegin(GL_LINES);
+    for (int i = 0; i < pointCount; i++) glVertex3fv(&points[i * 3]);
+    glEnd();
+}
+
 void DisplayManager::drawVList(BRLCAD::VectorList *vectorList)
 {
+    if (recordingBatch != nullptr) {
+        BatchVListElementCallback batchVListElementCallback(recordingBatch);
+        vectorList->Iterate(batchVListElementCallback);
+        return;
+    }
+    if (useShaders()) {
+        Batch batch;
+        std::copy(wireColor, wireColor + 4, batch.color);
+        BatchVListElementCallback batchVListElementCallback(&batch);
+        vectorList->Iterate(batchVListElementCallback);
+        uploadBatch(&batch);
+        drawBatch(&batch);
+        batch.buffer.destroy();
+        return;
+    }
+
     GLfloat originalPointSize, originalLineWidth;
     glGetFloatv(GL_POINT_SIZE, &originalPointSize);
     glGetFloatv(GL_LINE_WIDTH, &originalLineWidth);
 
     DrawVListElementCallback::DrawVlistVars vars;
     DrawVListElementCallback drawVListElementCallback(this, &vars);
-    if (dmLight) glEnable(GL_LIGHTING);
     vectorList->Iterate(drawVListElementCallback);
-    
+
 
     if (vars.first == 0)
         glEnd();
@@ -287,6 +617,11 @@ void DisplayManager::setFGColor(float r, float g, float b, float transparency) {
     backDiffuseColorLight[2] = wireColor[2] * 0.9f;
     backDiffuseColorLight[3] = wireColor[3];
 
+    if (recordingBatch != nullptr) {
+        std::copy(wireColor, wireColor + 4, recordingBatch->color);
+        return;
+    }
+
     glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, ambientColor);
     glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specularColor);
     glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, diffuseColor);
@@ -317,6 +652,7 @@ void DisplayManager::setLineStyle(int style) {
 
 void DisplayManager::setLineWidth(int width)
 {
+    shaderState.lineWidth = width;
     glLineWidth((GLfloat) width);
 }
 
@@ -330,6 +666,7 @@ void DisplayManager::setLineWidth(int width)
 void DisplayManager::setLineAttr(int width, int style)
 {
     if (width>0) {
+        shaderState.lineWidth = width;
         glLineWidth((GLfloat) width);
     }
 
@@ -345,6 +682,11 @@ void DisplayManager::setLineAttr(int width, int style)
  * Displays a saved display list identified by `list`
  */
 void DisplayManager::drawDList(unsigned int list) {
+    if (useShaders()) {
+        Batch *batch = batches.value(list);
+        if (batch != nullptr) drawBatch(batch);
+        return;
+    }
     glCallList((GLuint) list);
 }
 
@@ -353,6 +695,12 @@ void DisplayManager::drawDList(unsigned int list) {
  */
 unsigned int DisplayManager::genDLists(size_t range)
 {
+    if (useShaders()) {
+        const unsigned int first = nextBatchId;
+        nextBatchId += range;
+        for (unsigned int list = first; list < nextBatchId; list++) batches[list] = new Batch();
+        return first;
+    }
     return glGenLists((GLsizei)range);
 }
 
@@ -362,6 +710,10 @@ unsigned int DisplayManager::genDLists(size_t range)
  */
 void DisplayManager::beginDList(unsigned int list)
 {
+    if (useShaders()) {
+        recordingBatch = batches.value(list);
+        return;
+    }
     glNewList((GLuint)list, GL_COMPILE);
 }
 
@@ -370,6 +722,11 @@ void DisplayManager::beginDList(unsigned int list)
  */
 void DisplayManager::endDList()
 {
+    if (useShaders()) {
+        if (recordingBatch != nullptr) uploadBatch(recordingBatch);
+        recordingBatch = nullptr;
+        return;
+    }
     glEndList();
 }
 
@@ -378,15 +735,79 @@ void DisplayManager::endDList()
  */
 GLboolean DisplayManager::isDListValid(unsigned int list)
 {
+    if (useShaders()) return batches.contains(list);
     return glIsList(list);
 }
 
+/*
+ * Lighting is not compiled into display lists. This lets the same display list to be drawn lit (normal rendering)
+ * or in a single flat color (object id buffer used for picking).
+ */
+void DisplayManager::setLightingEnabled(bool enabled)
+{
+    shaderState.lightingEnabled = enabled && dmLight;
+    if (enabled && dmLight) glEnable(GL_LIGHTING);
+    else glDisable(GL_LIGHTING);
+}
+
+// Needed for shaded meshes. Wireframes are drawn without it.
+void DisplayManager::setDepthTestEnabled(bool enabled)
+{
+    if (enabled) glEnable(GL_DEPTH_TEST);
+    else glDisable(GL_DEPTH_TEST);
+}
+
+/*
+ * Sets the color used when lighting is disabled
+ */
+void DisplayManager::setFlatColor(float r, float g, float b)
+{
+    shaderState.flatColor[0] = r;
+    shaderState.flatColor[1] = g;
+    shaderState.flatColor[2] = b;
+    shaderState.flatColor[3] = 1;
+    glColor3f(r, g, b);
+}
+
+/*
+ * Sets the flat color used to draw the object `objectId` into the object id buffer.
+ * Lighting should be disabled for this color to take effect.
+ */
+void DisplayManager::setIdColor(unsigned int objectId)
+{
+    shaderState.flatColor[0] = (objectId & 0xFF) / 255.f;
+    shaderState.flatColor[1] = ((objectId >> 8) & 0xFF) / 255.f;
+    shaderState.flatColor[2] = ((objectId >> 16) & 0xFF) / 255.f;
+    shaderState.flatColor[3] = 1;
+    glColor4ub(objectId & 0xFF, (objectId >> 8) & 0xFF, (objectId >> 16) & 0xFF, 0xFF);
+}
+
+/*
+ * Inverse of setIdColor. Returns the objectId from a pixel read from the object id buffer.
+ */
+unsigned int DisplayManager::idFromColor(const unsigned char *rgba)
+{
+    return rgba[0] | (rgba[1] << 8) | (rgba[2] << 16);
+}
+
 void DisplayManager::freeDLists(unsigned int list, int range)
 {
+    if (useShaders()) {
+        for (unsigned int i = list; i < list + range; i++) {
+            Batch *batch = batches.take(i);
+            if (batch == nullptr) continue;
+            batch->buffer.destroy();
+            batch->meshBuffer.destroy();
+            batch->indexBuffer.destroy();
+            delete batch;
+        }
+        return;
+    }
     glDeleteLists((GLuint)list, (GLsizei)range);
 }
 void DisplayManager::drawBegin()
 {
+    useShaders();
     glClearColor(bgColor[0],bgColor[1],bgColor[2],1);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 //    glMatrixMode(GL_PROJECTION);
@@ -396,23 +817,48 @@ void DisplayManager::drawBegin()
 
 }
 
+/*
+ * Saves the state changed by the renderers. Only the attribute groups they touch are pushed,
+ * pushing GL_ALL_ATTRIB_BITS every frame is expensive on modern drivers.
+ */
 void DisplayManager::saveState(){
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    savedShaderStates.push(shaderState);
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT | GL_LINE_BIT | GL_POINT_BIT | GL_LIGHTING_BIT);
 }
 void DisplayManager::restoreState(){
+    if (!savedShaderStates.isEmpty()) shaderState = savedShaderStates.pop();
     glPopAttrib();
 }
 
+// the matrices are also loaded into the fixed function pipeline for the renderers that still use it
 void DisplayManager::loadMatrix(const GLfloat *m)
 {
+    modelViewMatrix = QMatrix4x4(m).transposed();
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
     glLoadMatrixf(m);
 }
 void DisplayManager::loadPMatrix(const GLfloat *m)
 {
+    projectionMatrix = QMatrix4x4(m).transposed();
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     glLoadMatrixf(m);
 }
 
+void DisplayManager::pushModelMatrix(const QMatrix4x4 &model)
+{
+    savedModelViewMatrices.push(modelViewMatrix);
+    modelViewMatrix = modelViewMatrix * model;
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glMultMatrixf(model.constData());
+}
+
+void DisplayManager::popModelMatrix()
+{
+    if (!savedModelViewMatrices.isEmpty()) modelViewMatrix = savedModelViewMatrices.pop();
+    glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
+}
+
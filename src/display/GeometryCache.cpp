@@ -0,0 +1,137 @@
+/*                G E O M E T R Y C A C H E . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file GeometryCache.cpp */
+
+#include <algorithm>
+#include <cstring>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QVector>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include "GeometryCache.h"
+
+const char GeometryCache::magic[8] = {'A', 'R', 'B', 'G', 'E', 'O', 'M', '\0'};
+qint64 GeometryCache::size = -1;
+
+GeometryCache::GeometryCache() {
+    // same organization and application names as the QSettings of MainWindow
+    const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    directory = cacheLocation + "/BRLCAD/arbalest/geometry";
+    available = !cacheLocation.isEmpty() && QDir().mkpath(directory);
+}
+
+// Entries are spread over 256 sub directories to keep directories small for big models
+QString GeometryCache::entryPath(const QByteArray &key) const {
+    return directory + "/" + key.left(2) + "/" + key + ".geom";
+}
+
+bool GeometryCache::load(const QByteArray &key, Entry &entry) {
+    if (!available) return false;
+
+    entry.file.setFileName(entryPath(key));
+    if (!entry.file.open(QIODevice::ReadOnly)) return false;
+    if (entry.file.size() < qint64(sizeof(Header))) return false;
+
+    const uchar *data = entry.file.map(0, entry.file.size());
+    if (data == nullptr) return false;
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    const qint64 expectedSize = sizeof(Header) + qint64(header.vertexCount) * header.floatsPerVertex * sizeof(float) +
+                                qint64(header.indexCount) * sizeof(quint32);
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version ||
+        (header.floatsPerVertex != 3 && header.floatsPerVertex != 6) || entry.file.size() != expectedSize) {
+        entry.file.unmap(const_cast<uchar *>(data));
+        entry.file.close();
+        return false;
+    }
+
+    // the modification time is the last use of the entry, for prune
+    QFile lastUse(entry.file.fileName());
+    if (lastUse.open(QIODevice::Append)) lastUse.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+    entry.floatsPerVertex = header.floatsPerVertex;
+    entry.vertexCount = header.vertexCount;
+    entry.indexCount = header.indexCount;
+    entry.vertices = reinterpret_cast<const float *>(data + sizeof(Header));
+    entry.indices = reinterpret_cast<const unsigned int *>(data + sizeof(Header) + header.vertexCount * header.floatsPerVertex * sizeof(float));
+    return true;
+}
+
+// Written to a temporary file and renamed, so a crash can not leave a truncated entry behind
+void GeometryCache::store(const QByteArray &key, const float *vertices, unsigned int floatsPerVertex,
+                          unsigned int vertexCount, const unsigned int *indices, unsigned int indexCount) {
+    if (!available) return;
+
+    if (size == -1) prune();
+
+    const QString path = entryPath(key);
+    if (!QDir().mkpath(QFileInfo(path).path())) return;
+    const qint64 previousSize = QFileInfo(path).size();
+
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.floatsPerVertex = floatsPerVertex;
+    header.vertexCount = vertexCount;
+    header.indexCount = indexCount;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char *>(vertices), qint64(vertexCount) * floatsPerVertex * sizeof(float));
+    if (indexCount > 0) file.write(reinterpret_cast<const char *>(indices), qint64(indexCount) * sizeof(unsigned int));
+    if (!file.commit()) return;
+
+    size += sizeof(Header) + qint64(vertexCount) * floatsPerVertex * sizeof(float) + qint64(indexCount) * sizeof(unsigned int) - previousSize;
+    if (size > maximumSize) prune();
+}
+
+// Scans the directory and, if it is over maximumSize, deletes the least recently used entries until it is under
+// three quarters of it, so that the next stores do not scan it again right away
+void GeometryCache::prune() {
+    struct EntryFile {
+        QString path;
+        QDateTime lastUse;
+        qint64 size;
+    };
+    QVector<EntryFile> entryFiles;
+    size = 0;
+    QDirIterator it(directory, QStringList("*.geom"), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fileInfo = it.fileInfo();
+        entryFiles.append({fileInfo.filePath(), fileInfo.lastModified(), fileInfo.size()});
+        size += fileInfo.size();
+    }
+    if (size <= maximumSize) return;
+
+    std::sort(entryFiles.begin(), entryFiles.end(), [](const EntryFile &a, const EntryFile &b) {
+        return a.lastUse < b.lastUse;
+    });
+    for (const EntryFile &entryFile : entryFiles) {
+        if (size <= maximumSize / 4 * 3) break;
+        // an entry mapped by a document can not be deleted on Windows. It is tried again by the next prune.
+        if (QFile::remove(entryFile.path)) size -= entryFile.size;
+    }
+}
@@ -20,61 +20,278 @@
  /** @file GeometryRenderer.cpp */
 
 #include "GeometryRenderer.h"
+#include <algorithm>
+#include "Globals.h"
+#include "QSSPreprocessor.h"
+#include "Tessellator.h"
+#include <QSettings>
+
+// Computes the bounding box of the points of a vector list
+class BoundingBoxVListCallback : public BRLCAD::VectorList::ElementCallback {
+public:
+    BoundingBox boundingBox;
+
+    bool operator()(BRLCAD::VectorList::Element* element) override {
+        if (!element) return true;
+
+        switch (element->Type()) {
+            case BRLCAD::VectorList::Element::LineMove:
+                boundingBox.extend(dynamic_cast<BRLCAD::VectorList::LineMove *>(element)->Point().coordinates);
+                break;
+            case BRLCAD::VectorList::Element::LineDraw:
+                boundingBox.extend(dynamic_cast<BRLCAD::VectorList::LineDraw *>(element)->Point().coordinates);
+                break;
+            case BRLCAD::VectorList::Element::PolygonMove:
+                boundingBox.extend(dynamic_cast<BRLCAD::VectorList::PolygonMove *>(element)->Point().coordinates);
+                break;
+            case BRLCAD::VectorList::Element::PolygonDraw:
+                boundingBox.extend(dynamic_cast<BRLCAD::VectorList::PolygonDraw *>(element)->Point().coordinates);
+                break;
+            case BRLCAD::VectorList::Element::PolygonEnd:
+                boundingBox.extend(dynamic_cast<BRLCAD::VectorList::PolygonEnd *>(element)->Point().coordinates);
+                break;
+            case BRLCAD::VectorList::Element::TriangleMove:
+                boundingBox.extend(dynamic_cast<BRLCAD::VectorList::TriangleMove *>(element)->Point().coordinates);
+                break;
+            case BRLCAD::VectorList::Element::TriangleDraw:
+                boundingBox.extend(dynamic_cast<BRLCAD::VectorList::TriangleDraw *>(element)->Point().coordinates);
+                break;
+            case BRLCAD::VectorList::Element::PointDraw:
+                boundingBox.extend(dynamic_cast<BRLCAD::VectorList::PointDraw *>(element)->Point().coordinates);
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+};
+
+// Collects the line segments of a wireframe vector list, to be stored in GeometryCache
+class LineSegmentsVListCallback : public BRLCAD::VectorList::ElementCallback {
+public:
+    QVector<float> points;  // each pair of points is a segment
+    bool onlyLines = true;  // false if the vector list has elements that are not stored in the cache (ex: polygons)
+
+    bool operator()(BRLCAD::VectorList::Element* element) override {
+        if (!element) return true;
+
+        switch (element->Type()) {
+            case BRLCAD::VectorList::Element::LineMove: {
+                const BRLCAD::Vector3D point = dynamic_cast<BRLCAD::VectorList::LineMove *>(element)->Point();
+                std::copy(point.coordinates, point.coordinates + 3, lastPoint);
+                hasLastPoint = true;
+                break;
+            }
+            case BRLCAD::VectorList::Element::LineDraw: {
+                const BRLCAD::Vector3D point = dynamic_cast<BRLCAD::VectorList::LineDraw *>(element)->Point();
+                if (hasLastPoint) {
+                    points << lastPoint[0] << lastPoint[1] << lastPoint[2];
+                    points << point.coordinates[0] << point.coordinates[1] << point.coordinates[2];
+                }
+                std::copy(point.coordinates, point.coordinates + 3, lastPoint);
+                hasLastPoint = true;
+                break;
+            }
+            case BRLCAD::VectorList::Element::LineWidth:
+                break;
+            default:
+                onlyLines = false;
+                return false;
+        }
+        return true;
+    }
+
+private:
+    double lastPoint[3];
+    bool hasLastPoint = false;
+};
 
 
 GeometryRenderer::GeometryRenderer(Document* document) : document(document)
 {
+    QColor color = Globals::theme->getColor("$Color-HighlightedObject");
+    highlightColor[0] = color.redF();
+    highlightColor[1] = color.greenF();
+    highlightColor[2] = color.blueF();
+
+    QSettings settings("BRLCAD", "arbalest");
+    shaded = settings.value("shadedMode", false).toBool();
+
     refreshForVisibilityAndSolidChanges();
 }
 
 void GeometryRenderer::render() {
+    updateDisplayLists();
+    updatePreviewDisplayLists();
+
     document->getDisplay()->getDisplayManager()->saveState();
-    if (!objectsToBeDisplayedIds.empty()) {
-        for (int objectId : objectsToBeDisplayedIds) {
-            if (!objectIdDisplayListIdMap.contains(objectId)) {
-                drawSolid(objectId);
-            }
-            visibleDisplayListIds.append(objectIdDisplayListIdMap[objectId]);
+    document->getDisplay()->getDisplayManager()->setLightingEnabled(true);
+    document->getDisplay()->getDisplayManager()->setDepthTestEnabled(shaded);
+    if (minimumVisibleObjectSize <= 0 && previewObjectIdDisplayListIdMap.isEmpty() && objectIdTransformMap.isEmpty()) {
+        for (int displayListId : visibleDisplayListIds) {
+            document->getDisplay()->getDisplayManager()->drawDList(displayListId);
         }
-        objectsToBeDisplayedIds.clear();
     }
+    else {
+        for (int i = 0; i < visibleDisplayListIds.size(); i++) {
+            if (minimumVisibleObjectSize > 0 && objectIdSizeMap.value(visibleObjectIds[i], 0) < minimumVisibleObjectSize) continue;
+            if (previewObjectIdDisplayListIdMap.contains(visibleObjectIds[i])) continue;
+            drawDisplayList(visibleObjectIds[i], visibleDisplayListIds[i]);
+        }
 
-    for (int displayListId : visibleDisplayListIds) {
+        // the previewed instances are drawn over the scene so they stay visible while being resized inside others
+        document->getDisplay()->getDisplayManager()->setDepthTestEnabled(false);
+        for (int displayListId : previewObjectIdDisplayListIdMap) {
+            document->getDisplay()->getDisplayManager()->drawDList(displayListId);
+        }
+        document->getDisplay()->getDisplayManager()->setDepthTestEnabled(shaded);
+    }
+
+    // the highlighted object is drawn again on top in a flat color
+    if (highlightedObjectId != -1 && objectIdDisplayListIdMap.contains(highlightedObjectId)) {
+        document->getDisplay()->getDisplayManager()->setLightingEnabled(false);
+        document->getDisplay()->getDisplayManager()->setFlatColor(highlightColor[0], highlightColor[1], highlightColor[2]);
+        document->getDisplay()->getDisplayManager()->setLineWidth(highlightLineWidth);
+        drawDisplayList(highlightedObjectId, previewObjectIdDisplayListIdMap.value(highlightedObjectId, objectIdDisplayListIdMap[highlightedObjectId]));
+    }
+    document->getDisplay()->getDisplayManager()->restoreState();
+}
+
+// Draws the display list of a solid, moved by its transform from setTransform if it has one
+void GeometryRenderer::drawDisplayList(int objectId, int displayListId) {
+    const QHash<int, QMatrix4x4>::const_iterator transform = objectIdTransformMap.find(objectId);
+    if (transform == objectIdTransformMap.end()) {
         document->getDisplay()->getDisplayManager()->drawDList(displayListId);
+        return;
+    }
+    document->getDisplay()->getDisplayManager()->pushModelMatrix(*transform);
+    document->getDisplay()->getDisplayManager()->drawDList(displayListId);
+    document->getDisplay()->getDisplayManager()->popModelMatrix();
+}
+
+// Draws every visible solid in a flat color encoding its objectId. Used to render the object id buffer for picking.
+void GeometryRenderer::renderObjectIds(int lineWidth) {
+    updateDisplayLists();
+    updatePreviewDisplayLists();
+
+    document->getDisplay()->getDisplayManager()->saveState();
+    document->getDisplay()->getDisplayManager()->setLightingEnabled(false);
+    for (int i = 0; i < visibleDisplayListIds.size(); i++) {
+        document->getDisplay()->getDisplayManager()->setIdColor(visibleObjectIds[i]);
+        // display lists restore the line width at their end, so this has to be set for each of them
+        document->getDisplay()->getDisplayManager()->setLineWidth(lineWidth);
+        drawDisplayList(visibleObjectIds[i], visibleDisplayListIds[i]);
     }
     document->getDisplay()->getDisplayManager()->restoreState();
 }
 
+// Generates display lists for the objects that became visible since the last call
+void GeometryRenderer::updateDisplayLists() {
+    if (objectsToBeDisplayedIds.empty()) return;
+
+    for (int objectId : objectsToBeDisplayedIds) {
+        if (!objectIdDisplayListIdMap.contains(objectId)) {
+            drawSolid(objectId);
+        }
+        visibleDisplayListIds.append(objectIdDisplayListIdMap[objectId]);
+        visibleObjectIds.append(objectId);
+    }
+    objectsToBeDisplayedIds.clear();
+    visibleObjectsVersion++;
+}
+
 
 void GeometryRenderer::drawSolid(int objectId) {
-    const ColorInfo colorInfo = document->getObjectTree()->getColorMap()[objectId];
+    QMutexLocker librtLocker(&Globals::librtMutex);
     const QString objectFullPath = document->getObjectTree()->getFullPathMap()[objectId];
+
+    // geometry of solids from saved files is taken from the on-disk cache when possible
+    QByteArray cacheKey;
+    const bool cacheable = document->getTessellator()->cacheKey(objectFullPath, shaded, cacheKey);
+    GeometryCache::Entry cacheEntry;
+    const bool cached = cacheable && geometryCache.load(cacheKey, cacheEntry);
+
+    // in shaded mode, solids which can not be tessellated are still drawn as wireframes
+    TriangleMesh mesh;
     BRLCAD::VectorList vectorList;
-    document->getDatabase()->Plot(objectFullPath.toUtf8(), vectorList);
+    if (!cached) {
+        if (!shaded || !document->getTessellator()->tessellate(objectFullPath, mesh)) {
+            document->getDatabase()->Plot(objectFullPath.toUtf8(), vectorList);
+        }
+
+        if (cacheable && !mesh.isEmpty()) {
+            geometryCache.store(cacheKey, mesh.vertices.constData(), 6, mesh.vertices.size() / 6,
+                                mesh.indices.constData(), mesh.indices.size());
+        }
+        else if (cacheable) {
+            LineSegmentsVListCallback lineSegmentsVListCallback;
+            vectorList.Iterate(lineSegmentsVListCallback);
+            if (lineSegmentsVListCallback.onlyLines) {
+                geometryCache.store(cacheKey, lineSegmentsVListCallback.points.constData(), 3,
+                                    lineSegmentsVListCallback.points.size() / 3, nullptr, 0);
+            }
+        }
+    }
 
     clearSolidIfAvailable(objectId);
 
+    BoundingBox boundingBox;
+    if (cached) {
+        boundingBox.extend(cacheEntry.vertices, cacheEntry.vertexCount, cacheEntry.floatsPerVertex);
+    }
+    else if (!mesh.isEmpty()) {
+        boundingBox = mesh.boundingBox();
+    }
+    else {
+        BoundingBoxVListCallback boundingBoxVListCallback;
+        vectorList.Iterate(boundingBoxVListCallback);
+        boundingBox = boundingBoxVListCallback.boundingBox;
+    }
+    document->getObjectTree()->setSolidBoundingBox(objectId, boundingBox);
+    objectIdSizeMap[objectId] = boundingBox.isEmpty() ? 0 : std::max({boundingBox.maxima[0] - boundingBox.minima[0],
+                                                                      boundingBox.maxima[1] - boundingBox.minima[1],
+                                                                      boundingBox.maxima[2] - boundingBox.minima[2]});
+
     const unsigned int displayListId = document->getDisplay()->getDisplayManager()->genDLists(1);
     document->getDisplay()->getDisplayManager()->beginDList(displayListId);  // begin display list --------------
 
-    if (colorInfo.hasColor) {
-        document->getDisplay()->getDisplayManager()->setFGColor(colorInfo.red, colorInfo.green, colorInfo.blue, 1);
+    setSolidColor(objectId);
+
+    //displayManager->setLineStyle(tsp->ts_sofar & (TS_SOFAR_MINUS | TS_SOFAR_INTER));
+    if (cached && cacheEntry.floatsPerVertex == 6) {
+        document->getDisplay()->getDisplayManager()->drawMesh(cacheEntry.vertices, cacheEntry.vertexCount,
+                                                              cacheEntry.indices, cacheEntry.indexCount);
+    }
+    else if (cached) {
+        document->getDisplay()->getDisplayManager()->drawLines(cacheEntry.vertices, cacheEntry.vertexCount);
+    }
+    else if (!mesh.isEmpty()) {
+        document->getDisplay()->getDisplayManager()->drawMesh(mesh);
     }
     else {
-        document->getDisplay()->getDisplayManager()->setFGColor(defaultWireColor[0], defaultWireColor[1], defaultWireColor[2], 1);
+        document->getDisplay()->getDisplayManager()->drawVList(&vectorList);
     }
-
-    //displayManager->setLineStyle(tsp->ts_sofar & (TS_SOFAR_MINUS | TS_SOFAR_INTER));
-    document->getDisplay()->getDisplayManager()->drawVList(&vectorList);
     document->getDisplay()->getDisplayManager()->endDList();     // end display list --------------
 
     objectIdDisplayListIdMap[objectId] = displayListId;
 }
 
 
+void GeometryRenderer::setSolidColor(int objectId) {
+    const ColorInfo colorInfo = document->getObjectTree()->getColorMap()[objectId];
+    if (colorInfo.hasColor) {
+        document->getDisplay()->getDisplayManager()->setFGColor(colorInfo.red, colorInfo.green, colorInfo.blue, 1);
+    }
+    else {
+        document->getDisplay()->getDisplayManager()->setFGColor(defaultWireColor[0], defaultWireColor[1], defaultWireColor[2], 1);
+    }
+}
+
 
 void GeometryRenderer::refreshForVisibilityAndSolidChanges() {
     visibleDisplayListIds.clear();
+    visibleObjectIds.clear();
+    visibleObjectsVersion++;
     document->getObjectTree()->traverseSubTree(0, false,[this]
         (int objectId)
         {
@@ -90,14 +307,163 @@ void GeometryRenderer::clearSolidIfAvailable(int objectId) {
     if (objectIdDisplayListIdMap.contains(objectId)){
         document->getDisplay()->getDisplayManager()->freeDLists(objectIdDisplayListIdMap[objectId], 1);
         objectIdDisplayListIdMap.remove(objectId);
+        document->getObjectTree()->removeSolidBoundingBox(objectId);
+        objectIdSizeMap.remove(objectId);
     }
 }
 
+// Called outside of paintGL, so the context that owns the display lists has to be made current here
 void GeometryRenderer::clearObject(int objectId) {
+    document->getDisplay()->makeCurrent();
     document->getObjectTree()->traverseSubTree(objectId, true, [this](int objectId){
         clearSolidIfAvailable(objectId);
         return true;
     });
+    document->getDisplay()->doneCurrent();
+}
+
+void GeometryRenderer::clearObjects(const QVector<int> &objectIds) {
+    document->getDisplay()->makeCurrent();
+    for (int objectId : objectIds) {
+        document->getObjectTree()->traverseSubTree(objectId, true, [this](int objectId){
+            clearSolidIfAvailable(objectId);
+            return true;
+        });
+    }
+    document->getDisplay()->doneCurrent();
+}
+
+// For objects that were removed from the tree. Their ids are no longer in it, so the ids are given one by one.
+void GeometryRenderer::removeObjects(const QVector<int> &objectIds) {
+    document->getDisplay()->makeCurrent();
+    for (int objectId : objectIds) {
+        clearSolidIfAvailable(objectId);
+        objectIdTransformMap.remove(objectId);
+        if (highlightedObjectId == objectId) highlightedObjectId = -1;
+    }
+    document->getDisplay()->doneCurrent();
+}
+
+/*
+ * Draws the solids under objectId moved by transform (in world coordinates) until clearTransforms(objectId).
+ * The display lists are kept, so only a matrix changes per frame. Used while a transform is edited, before it is applied.
+ */
+void GeometryRenderer::setTransform(int objectId, const QMatrix4x4 &transform) {
+    document->getObjectTree()->traverseSubTree(objectId, true, [this, &transform](int objectId){
+        if (document->getObjectTree()->getDrawableObjectIds().contains(objectId)) objectIdTransformMap[objectId] = transform;
+        return true;
+    });
 }
 
+void GeometryRenderer::clearTransforms(int objectId) {
+    document->getObjectTree()->traverseSubTree(objectId, true, [this](int objectId){
+        objectIdTransformMap.remove(objectId);
+        return true;
+    });
+}
 
+void GeometryRenderer::setHighlightedObjectId(int objectId) {
+    highlightedObjectId = objectId;
+}
+
+/*
+ * Switches between wireframes (from Plot) and shaded triangle meshes (from Tessellator).
+ * All the display lists are regenerated.
+ */
+void GeometryRenderer::setShaded(bool shaded) {
+    if (this->shaded == shaded) return;
+    this->shaded = shaded;
+
+    document->getDisplay()->makeCurrent();
+    for (int objectId : objectIdDisplayListIdMap.keys()) clearSolidIfAvailable(objectId);
+    document->getDisplay()->doneCurrent();
+    refreshForVisibilityAndSolidChanges();
+}
+
+// Solids whose largest bounding box extent is below size are skipped by render(). 0 draws everything.
+void GeometryRenderer::setMinimumVisibleObjectSize(double size) {
+    minimumVisibleObjectSize = size;
+}
+
+/*
+ * Draws object instead of its visible instances without changing the database. The first call for an object copies
+ * the combinations on the paths to its instances to the preview database, later calls only replace the object.
+ * Plotting is left to the next frame, so when a drag produces several values per frame only the last one is plotted.
+ */
+void GeometryRenderer::setPreviewObject(const BRLCAD::Object &object) {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    const QString objectName = object.Name();
+    if (previewDatabase == nullptr || previewObjectName != objectName) {
+        clearPreview();
+        previewDatabase = new BRLCAD::MemoryDatabase();
+        previewObjectName = objectName;
+
+        ObjectTree *objectTree = document->getObjectTree();
+        for (int objectId : objectTree->getObjectIds(objectName)) {
+            if (!objectTree->getDrawableObjectIds().contains(objectId)) continue;
+            if (objectTree->getObjectVisibility().value(objectId) != ObjectTree::FullyVisible) continue;
+            previewObjectIds.append(objectId);
+            for (int ancestorId = objectTree->getParent()[objectId]; ancestorId > 0;
+                 ancestorId = objectTree->getParent()[ancestorId]) {
+                copyToPreviewDatabase(objectTree->getNameMap()[ancestorId]);
+            }
+        }
+        previewDatabase->Add(object);
+    }
+    else {
+        previewDatabase->Set(object);
+    }
+    previewPlotPending = true;
+}
+
+// Only the previewed object is plotted, and always as wireframe even in shaded mode, so this stays within a frame
+// while a parameter is dragged. The tessellated, full quality geometry is made once the edit is applied.
+// Called while the GL context is current.
+void GeometryRenderer::updatePreviewDisplayLists() {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    if (!previewPlotPending) return;
+    previewPlotPending = false;
+
+    for (int objectId : previewObjectIds) {
+        if (previewObjectIdDisplayListIdMap.contains(objectId)) {
+            document->getDisplay()->getDisplayManager()->freeDLists(previewObjectIdDisplayListIdMap[objectId], 1);
+        }
+
+        BRLCAD::VectorList vectorList;
+        previewDatabase->Plot(document->getObjectTree()->getFullPathMap()[objectId].toUtf8(), vectorList);
+
+        const unsigned int displayListId = document->getDisplay()->getDisplayManager()->genDLists(1);
+        document->getDisplay()->getDisplayManager()->beginDList(displayListId);
+        setSolidColor(objectId);
+        document->getDisplay()->getDisplayManager()->drawVList(&vectorList);
+        document->getDisplay()->getDisplayManager()->endDList();
+        previewObjectIdDisplayListIdMap[objectId] = displayListId;
+    }
+}
+
+void GeometryRenderer::clearPreview() {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    if (previewDatabase == nullptr) return;
+
+    document->getDisplay()->makeCurrent();
+    for (int displayListId : previewObjectIdDisplayListIdMap) {
+        document->getDisplay()->getDisplayManager()->freeDLists(displayListId, 1);
+    }
+    document->getDisplay()->doneCurrent();
+
+    delete previewDatabase;
+    previewDatabase = nullptr;
+    previewObjectName.clear();
+    previewDatabaseObjectNames.clear();
+    previewObjectIds.clear();
+    previewObjectIdDisplayListIdMap.clear();
+    previewPlotPending = false;
+}
+
+void GeometryRenderer::copyToPreviewDatabase(const QString &objectName) {
+    if (previewDatabaseObjectNames.contains(objectName)) return;
+    previewDatabaseObjectNames.insert(objectName);
+
+    const std::shared_ptr<const BRLCAD::Object> state = document->getObjectState(objectName);
+    if (state != nullptr) previewDatabase->Add(*state);
+}
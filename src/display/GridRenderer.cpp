@@ -6,45 +6,97 @@
 #endif
 
 #include <GL/gl.h>
+#include <algorithm>
 #include <cmath>
+#include <QVector2D>
 #include <iostream>
 #include "AxesRenderer.h"
 
+/*
+ * The grid is a single quad on the z = 0 plane around the point the camera looks at. The lines are computed
+ * analytically per fragment in grid.frag, so the cost does not depend on the zoom level or the number of lines.
+ */
 void GridRenderer::render() {
-    //todo implement line drawing in DisplayManager and use it instead of calling OpenGL here
+    if (!initialized) initialize();
+    if (program == nullptr) return;
 
-    int lineCount = 1000;
-    double lineGap;
-    lineGap = .1 * std::pow(2.71,int(std::log(display->getCamera()->getVerticalSpan())));
+    OrthographicCamera *camera = display->getCamera();
+    const double verticalSpan = camera->getVerticalSpan();
+    const double aspectRatio = std::max(1.0, double(display->getW()) / display->getH());
 
-    float length = lineCount*lineGap;
-    float lineColor[] = {.3,.3,.3};
+    // about 10 to 100 minor lines across the height of the display, blending into the next level as we zoom out
+    const double level = std::log10(verticalSpan / 10);
+    const float spacing = std::pow(10, std::floor(level));
+    const float lodFraction = level - std::floor(level);
+
+    // the grid fades out at fadeDistance, so the quad does not need to reach the horizon when it is seen at an angle
+    const float fadeDistance = fadeDistanceInVerticalSpans * verticalSpan * aspectRatio;
+    const QVector3D eyePosition = camera->getEyePosition();
+    QVector2D center(eyePosition.x(), eyePosition.y());
+    const BRLCAD::Ray3D centerRay = camera->rayThroughScreenPoint(display->getW() / 2, display->getH() / 2);
+    if (std::abs(centerRay.direction.coordinates[2]) > 1e-9) {
+        const double t = -centerRay.origin.coordinates[2] / centerRay.direction.coordinates[2];
+        const QVector2D hit(centerRay.origin.coordinates[0] + t * centerRay.direction.coordinates[0],
+                            centerRay.origin.coordinates[1] + t * centerRay.direction.coordinates[1]);
+        if ((hit - center).length() < fadeDistance) center = hit;
+    }
+
+    float alpha = sqrt(abs(std::fmod(abs(camera->getAnglesAroundAxes()[0]),180)-90)/90.)*.7;
+    if (abs(std::fmod(abs(camera->getAnglesAroundAxes()[0]),180)-90)<4) {
+        alpha = (abs(std::fmod(abs(camera->getAnglesAroundAxes()[0]),180)-90)/90.)*.7;
+    }
 
     display->getDisplayManager()->saveState();
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    float alpha = sqrt(abs(std::fmod(abs(display->getCamera()->getAnglesAroundAxes()[0]),180)-90)/90.)*.7;
-    if (abs(std::fmod(abs(display->getCamera()->getAnglesAroundAxes()[0]),180)-90)<4) {
-        alpha = (abs(std::fmod(abs(display->getCamera()->getAnglesAroundAxes()[0]),180)-90)/90.)*.7;
-    }
+    program->bind();
+    program->setUniformValue("lineColor", QVector3D(lineColor[0], lineColor[1], lineColor[2]));
+    program->setUniformValue("alpha", alpha);
+    program->setUniformValue("spacing", spacing);
+    program->setUniformValue("lodFraction", lodFraction);
+    program->setUniformValue("center", center);
+    program->setUniformValue("halfExtent", fadeDistance);
+    program->setUniformValue("fadeDistance", fadeDistance);
 
-    glColor4f(lineColor[0],lineColor[1],lineColor[2],alpha);
-    glBegin(GL_LINES);
-    for (double i = -lineCount*lineGap/2; i < lineCount*lineGap/2; i+=lineGap){
-        glVertex3f(i, length / 2, 0);
-        glVertex3f(i, -length / 2, 0);
-    }
+    quadBuffer.bind();
+    program->enableAttributeArray("position");
+    program->setAttributeBuffer("position", GL_FLOAT, 0, 2);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    program->disableAttributeArray("position");
+    quadBuffer.release();
+    program->release();
 
-    for (double i = -lineCount*lineGap/2; i < lineCount*lineGap/2; i+=lineGap){
-        glVertex3f(length / 2,i, 0);
-        glVertex3f(-length / 2,i, 0);
-    }
+    display->getDisplayManager()->restoreState();
+}
 
-    glEnd();
+// Compiles the shaders and uploads the quad. Needs the display's context to be current.
+void GridRenderer::initialize() {
+    initialized = true;
 
-    display->getDisplayManager()->restoreState();
+    program = new QOpenGLShaderProgram();
+    if (!program->addShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/grid.vert") ||
+        !program->addShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/grid.frag") ||
+        !program->link()) {
+        std::cerr << "Grid shaders could not be built. The grid will not be drawn." << std::endl
+                  << program->log().toStdString() << std::endl;
+        delete program;
+        program = nullptr;
+        return;
+    }
+
+    const float quadVertices[] = {-1, -1, 1, -1, -1, 1, 1, 1};
+    quadBuffer.create();
+    quadBuffer.bind();
+    quadBuffer.allocate(quadVertices, sizeof(quadVertices));
+    quadBuffer.release();
 }
 
 GridRenderer::GridRenderer(Display *display) : display(display) {}
+
+// The display's context has to be current when this is called
+GridRenderer::~GridRenderer() {
+    delete program;
+    quadBuffer.destroy();
+}
@@ -21,6 +21,7 @@
 
 #include "OrthographicCamera.h"
 #include "Utils.h"
+#include "Globals.h"
 #include <cmath>
 #include <QDebug>
 
@@ -137,19 +138,76 @@ double OrthographicCamera::getVerticalSpan()
     return this->verticalSpan;
 }
 
+/*
+ * Returns the ray going into the screen through the pixel (x, y) of the display.
+ * The origin is moved back to the near plane so that the ray covers everything the camera sees.
+ */
+BRLCAD::Ray3D OrthographicCamera::rayThroughScreenPoint(const int x, const int y) const {
+    const QMatrix4x4 inverseModelView = modelViewMatrix().inverted();
+    const QMatrix4x4 inverseRotation = modelViewMatrixNoTranslate().inverted();
+
+    // point on the plane of the eye (z = 0 in camera coordinates)
+    const float cameraX = (2.f * x / w - 1.f) * (verticalSpan / 2) * w / h;
+    const float cameraY = (1.f - 2.f * y / h) * (verticalSpan / 2);
+    const QVector3D pointOnEyePlane = inverseModelView.map(QVector3D(cameraX, cameraY, 0));
+    const QVector3D direction = inverseRotation.map(QVector3D(0, 0, -1)).normalized();
+
+    BRLCAD::Ray3D ray;
+    for (int i = 0; i < 3; i++) {
+        ray.direction.coordinates[i] = direction[i];
+        ray.origin.coordinates[i] = static_cast<double>(pointOnEyePlane[i]) - static_cast<double>(direction[i]) * farPlane;
+    }
+    return ray;
+}
+
 void OrthographicCamera::centerToCurrentSelection() {
-    BRLCAD::Vector3D a = document->getDatabase()->BoundingBoxMinima();
-    BRLCAD::Vector3D b = document->getDatabase()->BoundingBoxMaxima();
-    BRLCAD::Vector3D midPoint = (a+b) / 2;
-    setEyePosition(midPoint.coordinates[0], midPoint.coordinates[1], midPoint.coordinates[2]);
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    BoundingBox boundingBox;
+    boundingBox.extend(document->getDatabase()->BoundingBoxMinima().coordinates);
+    boundingBox.extend(document->getDatabase()->BoundingBoxMaxima().coordinates);
+    centerToBoundingBox(boundingBox);
+}
+
+void OrthographicCamera::centerToBoundingBox(const BoundingBox &boundingBox) {
+    if (boundingBox.isEmpty()) return;
+    setEyePosition(boundingBox.center(0), boundingBox.center(1), boundingBox.center(2));
 
-    const BRLCAD::Vector3D volume = (a - b);
-    double diagonalLength = vector3DLength(volume);
+    double diagonalLengthSquared = 0;
+    for (int i = 0; i < 3; i++) {
+        diagonalLengthSquared += (boundingBox.maxima[i] - boundingBox.minima[i]) * (boundingBox.maxima[i] - boundingBox.minima[i]);
+    }
+    double diagonalLength = std::sqrt(diagonalLengthSquared);
     if (diagonalLength > 0.001) setZoom(diagonalLength * 1.1);
     document->getDisplay()->forceRerenderFrame();
 }
 
+/*
+ * The boxes of the visible objects come from ObjectTree, which caches them per combination. Only when a visible
+ * solid has not been plotted yet does the database compute the box of the visible paths.
+ */
 void OrthographicCamera::autoview() {
+    BoundingBox boundingBox;
+    bool complete = true;
+    document->getObjectTree()->traverseSubTree(0, false, [this, &boundingBox, &complete]
+    (int objectId){
+        switch(document->getObjectTree()->getObjectVisibility()[objectId]){
+            case ObjectTree::Invisible:
+                return false;
+            case ObjectTree::SomeChildrenVisible:
+                return true;
+            case ObjectTree::FullyVisible:
+                if (!document->getObjectTree()->getBoundingBox(objectId, boundingBox)) complete = false;
+                return false;
+        }
+        return true;
+    }
+    );
+    if (complete) {
+        centerToBoundingBox(boundingBox);
+        return;
+    }
+
+    QMutexLocker librtLocker(&Globals::librtMutex);
     document->getDatabase()->UnSelectAll();
     document->getObjectTree()->traverseSubTree(0, false, [this]
     (int objectId){
@@ -171,6 +229,13 @@ void OrthographicCamera::autoview() {
 }
 
 void OrthographicCamera::centerView(int objectId) {
+    BoundingBox boundingBox;
+    if (document->getObjectTree()->getBoundingBox(objectId, boundingBox)) {
+        centerToBoundingBox(boundingBox);
+        return;
+    }
+
+    QMutexLocker librtLocker(&Globals::librtMutex);
     document->getDatabase()->UnSelectAll();
     QString fullPath = document->getObjectTree()->getFullPathMap()[objectId];
     document->getDatabase()->Select(fullPath.toUtf8());
@@ -0,0 +1,205 @@
+/*                     R A Y P I C K E R . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file RayPicker.cpp */
+
+#include <algorithm>
+#include <cmath>
+#include "RayPicker.h"
+#include "Document.h"
+#include "Globals.h"
+#include "GeometryRenderer.h"
+
+
+RayPicker::RayPicker(Document *document) : document(document) {}
+
+int RayPicker::pick(const BRLCAD::Ray3D &ray, bool confirmWithRaytrace) {
+    if (!built || builtVisibleObjectsVersion != document->getGeometryRenderer()->getVisibleObjectsVersion()) build();
+
+    std::vector<Candidate> candidates;
+    collectCandidates(ray, candidates);
+    if (candidates.empty()) return -1;
+
+    if (confirmWithRaytrace) return confirm(ray, candidates);
+
+    // Bounding boxes of solids are often nested (ex: a bolt inside the bounding box of a plate).
+    // Among the solids overlapping the front most one along the ray, take the smallest.
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.entryDistance < b.entryDistance;
+    });
+    const double frontExitDistance = candidates[0].exitDistance;
+    const Candidate *picked = &candidates[0];
+    for (const Candidate &candidate : candidates) {
+        if (candidate.entryDistance > frontExitDistance) break;
+        if (candidate.volume < picked->volume) picked = &candidate;
+    }
+    return picked->objectId;
+}
+
+void RayPicker::build() {
+    GeometryRenderer *geometryRenderer = document->getGeometryRenderer();
+    nodes.clear();
+    solids.clear();
+
+    const QHash<int, BoundingBox> &boundingBoxes = document->getObjectTree()->getSolidBoundingBoxMap();
+    for (int objectId : geometryRenderer->getVisibleObjectIds()) {
+        const QHash<int, BoundingBox>::const_iterator boundingBox = boundingBoxes.find(objectId);
+        if (boundingBox == boundingBoxes.end() || boundingBox->isEmpty()) continue;
+        solids.push_back({objectId, *boundingBox});
+    }
+
+    if (!solids.empty()) buildNode(0, static_cast<int>(solids.size()));
+
+    builtVisibleObjectsVersion = geometryRenderer->getVisibleObjectsVersion();
+    built = true;
+}
+
+// Builds the subtree for solids[first, first + count) by splitting at the median along the longest axis
+int RayPicker::buildNode(int first, int count) {
+    const int nodeIndex = static_cast<int>(nodes.size());
+    nodes.emplace_back();
+
+    BoundingBox boundingBox;
+    BoundingBox centersBoundingBox;
+    for (int i = first; i < first + count; i++) {
+        boundingBox.extend(solids[i].boundingBox);
+        const double center[3] = {solids[i].boundingBox.center(0), solids[i].boundingBox.center(1), solids[i].boundingBox.center(2)};
+        centersBoundingBox.extend(center);
+    }
+    nodes[nodeIndex].boundingBox = boundingBox;
+    nodes[nodeIndex].first = first;
+    nodes[nodeIndex].count = count;
+
+    if (count <= maxSolidsPerLeaf) return nodeIndex;
+
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+        if (centersBoundingBox.maxima[i] - centersBoundingBox.minima[i] > centersBoundingBox.maxima[axis] - centersBoundingBox.minima[axis]) axis = i;
+    }
+    if (centersBoundingBox.maxima[axis] - centersBoundingBox.minima[axis] <= 0) return nodeIndex;
+
+    const int half = count / 2;
+    std::nth_element(solids.begin() + first, solids.begin() + first + half, solids.begin() + first + count,
+            [axis](const Solid &a, const Solid &b) {
+                return a.boundingBox.center(axis) < b.boundingBox.center(axis);
+            });
+
+    const int left = buildNode(first, half);
+    const int right = buildNode(first + half, count - half);
+    nodes[nodeIndex].left = left;
+    nodes[nodeIndex].right = right;
+    return nodeIndex;
+}
+
+void RayPicker::collectCandidates(const BRLCAD::Ray3D &ray, std::vector<Candidate> &candidates) const {
+    if (nodes.empty()) return;
+
+    std::vector<int> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+
+        double entryDistance, exitDistance;
+        if (!intersect(node.boundingBox, ray, entryDistance, exitDistance)) continue;
+
+        if (node.left != -1) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        for (int i = node.first; i < node.first + node.count; i++) {
+            if (intersect(solids[i].boundingBox, ray, entryDistance, exitDistance)) {
+                candidates.push_back({solids[i].objectId, entryDistance, exitDistance, solids[i].boundingBox.volume()});
+            }
+        }
+    }
+}
+
+class PickCallback : public BRLCAD::ConstDatabase::HitCallback {
+public:
+    bool hit = false;
+    BRLCAD::Vector3D point;
+    QString regionPath;
+
+    virtual bool operator()(const BRLCAD::ConstDatabase::Hit& hit) throw() {
+        this->hit = true;
+        point = hit.PointIn();
+        regionPath = hit.Name();
+        return false;
+    }
+};
+
+// Shoots the ray at the candidate solids only and returns the candidate that the first hit belongs to.
+// The hit names the full path of the region it is in, which is the path of the solid or one of its parents.
+int RayPicker::confirm(const BRLCAD::Ray3D &ray, const std::vector<Candidate> &candidates) const {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    const QHash<int, QString> &fullPathMap = document->getObjectTree()->getFullPathMap();
+    document->getDatabase()->UnSelectAll();
+    for (const Candidate &candidate : candidates) {
+        document->getDatabase()->Select(fullPathMap[candidate.objectId].toUtf8());
+    }
+
+    PickCallback callback;
+    document->getDatabase()->ShootRay(ray, callback, BRLCAD::ConstDatabase::StopAfterFirstHit);
+    document->getDatabase()->UnSelectAll();
+    if (!callback.hit) return -1;
+
+    // A region can hold several of the candidates. Only then the hit point has to tell them apart.
+    const Candidate *picked = nullptr;
+    bool pickedContainsHit = false;
+    for (const Candidate &candidate : candidates) {
+        const QString &fullPath = fullPathMap[candidate.objectId];
+        if (fullPath != callback.regionPath && !fullPath.startsWith(callback.regionPath + "/")) continue;
+
+        const BoundingBox boundingBox = document->getObjectTree()->getSolidBoundingBoxMap().value(candidate.objectId);
+        const double tolerance = 1e-6 * std::cbrt(candidate.volume) + 1e-3;
+        const bool containsHit = boundingBox.contains(callback.point.coordinates, tolerance);
+        if (picked == nullptr || containsHit > pickedContainsHit || (containsHit == pickedContainsHit && candidate.volume < picked->volume)) {
+            picked = &candidate;
+            pickedContainsHit = containsHit;
+        }
+    }
+    return picked != nullptr ? picked->objectId : -1;
+}
+
+// Slab test. Returns the distances along the ray where it enters and exits the box.
+bool RayPicker::intersect(const BoundingBox &boundingBox, const BRLCAD::Ray3D &ray, double &entryDistance, double &exitDistance) {
+    entryDistance = -DBL_MAX;
+    exitDistance = DBL_MAX;
+
+    for (int i = 0; i < 3; i++) {
+        const double origin = ray.origin.coordinates[i];
+        const double direction = ray.direction.coordinates[i];
+
+        if (std::abs(direction) < 1e-12) {
+            if (origin < boundingBox.minima[i] || origin > boundingBox.maxima[i]) return false;
+            continue;
+        }
+
+        double near = (boundingBox.minima[i] - origin) / direction;
+        double far = (boundingBox.maxima[i] - origin) / direction;
+        if (near > far) std::swap(near, far);
+        if (near > entryDistance) entryDistance = near;
+        if (far < exitDistance) exitDistance = far;
+        if (entryDistance > exitDistance) return false;
+    }
+    return exitDistance >= 0;
+}
@@ -33,6 +33,7 @@
 #include <QPainter>
 
 #include "RaytraceView.h"
+#include "Globals.h"
 #include <QBitmap>
 #include <QtWidgets/QFileDialog>
 #include <QtOpenGL/QtOpenGL>
@@ -43,7 +44,6 @@ RaytraceView::RaytraceView
     QWidget*               parent
 ) : QWidget(parent),
     document(document),
-    m_database(*document->getDatabase()),
     m_transformation(),
     m_image(),
     m_imageUpTodate(false),
@@ -127,6 +127,7 @@ private:
 
 
 void RaytraceView::UpdateImage() {
+    QMutexLocker librtLocker(&Globals::librtMutex);
     int w  = width();
     int h = height();
 
@@ -151,7 +152,7 @@ void RaytraceView::UpdateImage() {
             ray.direction.coordinates[1] = direction.y();
             ray.direction.coordinates[2] = direction.z();
 
-            m_database.ShootRay(ray, callback, BRLCAD::ConstDatabase::StopAfterFirstHit);
+            document->getDatabase()->ShootRay(ray, callback, BRLCAD::ConstDatabase::StopAfterFirstHit);
 
             m_image.setPixelColor(column, row, callback.Color());
         }
@@ -160,6 +161,7 @@ void RaytraceView::UpdateImage() {
 
 
 void RaytraceView::raytrace() {
+    QMutexLocker librtLocker(&Globals::librtMutex);
     QSettings settings("BRLCAD", "arbalest");
     color=settings.value("raytraceBackground").value<QColor>();
     bool valid = color.isValid();
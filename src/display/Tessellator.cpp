@@ -0,0 +1,299 @@
+/*                   T E S S E L L A T O R . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file Tessellator.cpp */
+
+#include <cmath>
+#include <QDir>
+#include <QCryptographicHash>
+#include <brlcad/Combination.h>
+#include "Tessellator.h"
+#include "Document.h"
+#include "Globals.h"
+
+#include "raytrace.h"
+
+
+Tessellator::Tessellator(Document *document) : document(document) {}
+
+Tessellator::~Tessellator() {
+    close(baseDbip);
+    close(overlayDbip);
+    delete overlayFile;
+}
+
+void Tessellator::invalidate(const QString &objectName) {
+    changedObjectNames.insert(objectName);
+    close(overlayDbip);
+}
+
+// The file was replaced, so it is opened again. Objects edited again while saving stay changed.
+void Tessellator::saved(const QStringList &objectNames) {
+    QMutexLocker librtLocker(&Globals::librtMutex);
+    close(baseDbip);
+    close(overlayDbip);
+    for (const QString &objectName : objectNames) {
+        if (!document->getModifiedObjectNames().contains(objectName)) changedObjectNames.remove(objectName);
+    }
+}
+
+bool Tessellator::openBase() {
+    if (baseDbip != nullptr) return true;
+    if (document->getFilePath() == nullptr) return false;
+
+    baseDbip = db_open(document->getFilePath()->toUtf8().data(), DB_OPEN_READONLY);
+    if (baseDbip == DBI_NULL) {
+        baseDbip = nullptr;
+        return false;
+    }
+    if (db_dirbuild(baseDbip) < 0) {
+        close(baseDbip);
+        return false;
+    }
+    return true;
+}
+
+// Writes the changed objects, and only those, to the overlay file and opens it
+bool Tessellator::openOverlay() {
+    if (overlayDbip != nullptr) return true;
+
+    BRLCAD::MemoryDatabase overlay;
+    for (const QString &objectName : changedObjectNames) {
+        const std::shared_ptr<const BRLCAD::Object> state = document->getObjectState(objectName);
+        if (state != nullptr) overlay.Add(*state);
+    }
+
+    if (overlayFile == nullptr) {
+        overlayFile = new QTemporaryFile(QDir::tempPath() + "/arbalest_XXXXXX.g");
+        if (!overlayFile->open()) return false;
+        overlayFile->close();
+    }
+    if (!overlay.Save(overlayFile->fileName().toUtf8().data())) return false;
+
+    overlayDbip = db_open(overlayFile->fileName().toUtf8().data(), DB_OPEN_READONLY);
+    if (overlayDbip == DBI_NULL) {
+        overlayDbip = nullptr;
+        return false;
+    }
+    if (db_dirbuild(overlayDbip) < 0) {
+        close(overlayDbip);
+        return false;
+    }
+    return true;
+}
+
+void Tessellator::close(db_i *&dbip) {
+    if (dbip == nullptr) return;
+    db_close(dbip);
+    dbip = nullptr;
+}
+
+bool Tessellator::isChanged(const QStringList &objectNames) const {
+    for (const QString &objectName : objectNames) {
+        if (changedObjectNames.contains(objectName)) return true;
+    }
+    return false;
+}
+
+// Reads the triangles of an NMG model (after nmg_triangulate_model) into mesh.
+// Vertices shared by faces get the average of their normals, which gives smooth shading.
+static void readTriangles(struct model *m, TriangleMesh &mesh) {
+    QHash<const struct vertex *, unsigned int> vertexIndices;
+    QVector<double> normalSums;
+
+    struct nmgregion *r;
+    for (BU_LIST_FOR(r, nmgregion, &m->r_hd)) {
+        struct shell *s;
+        for (BU_LIST_FOR(s, shell, &r->s_hd)) {
+            struct faceuse *fu;
+            for (BU_LIST_FOR(fu, faceuse, &s->fu_hd)) {
+                if (fu->orientation != OT_SAME) continue;
+
+                vect_t faceNormal;
+                NMG_GET_FU_NORMAL(faceNormal, fu);
+
+                struct loopuse *lu;
+                for (BU_LIST_FOR(lu, loopuse, &fu->lu_hd)) {
+                    if (BU_LIST_FIRST_MAGIC(&lu->down_hd) != NMG_EDGEUSE_MAGIC) continue;
+
+                    QVector<unsigned int> loop;
+                    struct edgeuse *eu;
+                    for (BU_LIST_FOR(eu, edgeuse, &lu->down_hd)) {
+                        const struct vertex *v = eu->vu_p->v_p;
+                        if (!vertexIndices.contains(v)) {
+                            vertexIndices[v] = mesh.vertices.size() / 6;
+                            for (int i = 0; i < 3; i++) mesh.vertices.append(static_cast<float>(v->vg_p->coord[i]));
+                            for (int i = 0; i < 3; i++) mesh.vertices.append(0);
+                            for (int i = 0; i < 3; i++) normalSums.append(0);
+                        }
+                        const unsigned int index = vertexIndices[v];
+                        for (int i = 0; i < 3; i++) normalSums[index * 3 + i] += faceNormal[i];
+                        loop.append(index);
+                    }
+
+                    // loops are triangles after nmg_triangulate_model, but a fan keeps this safe for any convex loop
+                    for (int i = 1; i + 1 < loop.size(); i++) {
+                        mesh.indices << loop[0] << loop[i] << loop[i + 1];
+                    }
+                }
+            }
+        }
+    }
+
+    for (int index = 0; index < normalSums.size() / 3; index++) {
+        const double *n = &normalSums[index * 3];
+        const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0) continue;
+        for (int i = 0; i < 3; i++) mesh.vertices[index * 6 + 3 + i] = static_cast<float>(n[i] / length);
+    }
+}
+
+// Finds the leaf of fullPath, the database to read it from and the combined matrix of the path
+bool Tessellator::lookUp(const QString &fullPath, db_i *&dbip, directory *&leaf, double *matrix) {
+    const QStringList objectNames = fullPath.split("/", QString::SkipEmptyParts);
+    if (objectNames.isEmpty()) return false;
+
+    if (!isChanged(objectNames)) {
+        if (!openBase()) return false;
+        dbip = baseDbip;
+
+        struct db_full_path path;
+        db_full_path_init(&path);
+        if (db_string_to_path(&path, dbip, fullPath.toUtf8().data()) < 0 || path.fp_len == 0) {
+            db_free_full_path(&path);
+            return false;
+        }
+
+        MAT_IDN(matrix);
+        const bool success = db_path_to_mat(dbip, &path, matrix, 0, &rt_uniresource);
+        leaf = DB_FULL_PATH_CUR_DIR(&path);
+        db_free_full_path(&path);
+        return success;
+    }
+
+    // the file does not have the changed combinations, so the matrices of the path are read from the document
+    MAT_IDN(matrix);
+    for (int i = 0; i + 1 < objectNames.size(); i++) {
+        const std::shared_ptr<const BRLCAD::Object> state = document->getObjectState(objectNames[i]);
+        const BRLCAD::Combination *combination = dynamic_cast<const BRLCAD::Combination *>(state.get());
+        if (combination == nullptr) return false;
+        const double *leafMatrix = getLeafMatrix(combination->Tree(), objectNames[i + 1]);
+        if (leafMatrix == nullptr) continue;
+        mat_t product;
+        bn_mat_mul(product, matrix, leafMatrix);
+        MAT_COPY(matrix, product);
+    }
+
+    const QString &leafName = objectNames.last();
+    if (changedObjectNames.contains(leafName)) {
+        if (!openOverlay()) return false;
+        dbip = overlayDbip;
+    }
+    else {
+        if (!openBase()) return false;
+        dbip = baseDbip;
+    }
+    leaf = db_lookup(dbip, leafName.toUtf8().data(), LOOKUP_QUIET);
+    return leaf != RT_DIR_NULL;
+}
+
+/*
+ * Computes the key of the solid at fullPath in GeometryCache: a hash of its name, its serialized form, the matrix
+ * of its path, the display mode and the tolerances. Returns false if an object on the path has unsaved changes,
+ * since only the geometry of saved files is cached.
+ */
+bool Tessellator::cacheKey(const QString &fullPath, bool shaded, QByteArray &key) {
+    if (document->getFilePath() == nullptr || isChanged(fullPath.split("/", QString::SkipEmptyParts))) return false;
+
+    db_i *dbip;
+    directory *leaf;
+    mat_t matrix;
+    if (!lookUp(fullPath, dbip, leaf, matrix)) return false;
+
+    struct bu_external external;
+    if (db_get_external(&external, leaf, dbip) < 0) return false;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(leaf->d_namep);
+    hash.addData(reinterpret_cast<const char *>(external.ext_buf), external.ext_nbytes);
+    hash.addData(reinterpret_cast<const char *>(matrix), sizeof(mat_t));
+    hash.addData(shaded ? "shaded" : "wireframe");
+    if (shaded) {
+        hash.addData(reinterpret_cast<const char *>(&relativeTolerance), sizeof(relativeTolerance));
+        hash.addData(reinterpret_cast<const char *>(&distanceTolerance), sizeof(distanceTolerance));
+    }
+    bu_free_external(&external);
+
+    key = hash.result().toHex();
+    return true;
+}
+
+bool Tessellator::tessellate(const QString &fullPath, TriangleMesh &mesh) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
+
+    db_i *dbip;
+    directory *leaf;
+    mat_t matrix;
+    if (!lookUp(fullPath, dbip, leaf, matrix)) return false;
+
+    struct rt_db_internal intern;
+    if (rt_db_get_internal(&intern, leaf, dbip, matrix, &rt_uniresource) < 0) return false;
+
+    if (intern.idb_meth == nullptr || intern.idb_meth->ft_tessellate == nullptr) {
+        rt_db_free_internal(&intern);
+        return false;
+    }
+
+    struct bg_tess_tol ttol;
+    ttol.magic = BG_TESS_TOL_MAGIC;
+    ttol.abs = 0;
+    ttol.rel = relativeTolerance;
+    ttol.norm = 0;
+
+    struct bn_tol tol;
+    tol.magic = BN_TOL_MAGIC;
+    tol.dist = distanceTolerance;
+    tol.dist_sq = tol.dist * tol.dist;
+    tol.perp = 1e-6;
+    tol.para = 1 - tol.perp;
+
+    struct model *m = nmg_mm();
+    struct nmgregion *r = nullptr;
+    bool success = false;
+
+    // the facetizer reports failures with bu_bomb
+    if (!BU_SETJUMP) {
+        if (intern.idb_meth->ft_tessellate(&r, m, &intern, &ttol, &tol) == 0 && r != nullptr) {
+            nmg_triangulate_model(m, &RTG.rtg_vlfree, &tol);
+            readTriangles(m, mesh);
+            success = !mesh.isEmpty();
+        }
+    }
+    BU_UNSETJUMP;
+
+    nmg_km(m);
+    rt_db_free_internal(&intern);
+
+    if (!success) {
+        mesh.vertices.clear();
+        mesh.indices.clear();
+    }
+    return success;
+}
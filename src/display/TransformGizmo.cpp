@@ -0,0 +1,203 @@
+/*                 T R A N S F O R M G I Z M O . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file TransformGizmo.cpp */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "TransformGizmo.h"
+#include "Display.h"
+#include "Document.h"
+#include "DisplayManager.h"
+#include "GeometryRenderer.h"
+#include "OrthographicCamera.h"
+
+static const double pi = 3.14159265358979323846;
+
+TransformGizmo::TransformGizmo(Display *display, Document *document) : display(display), document(document) {}
+
+// Follows the current item of the object tree. Top objects have no matrix to edit, so they get no handles.
+bool TransformGizmo::updateObject() {
+    objectId = -1;
+    QTreeWidgetItem *item = document->getObjectTreeWidget()->currentItem();
+    if (item == nullptr) return false;
+    const int currentObjectId = item->data(0, Qt::UserRole).toInt();
+    if (document->getObjectTree()->getParent()[currentObjectId] == 0) return false;
+
+    BoundingBox boundingBox;
+    document->getObjectTree()->getBoundingBox(currentObjectId, boundingBox);
+    if (boundingBox.isEmpty()) return false;
+
+    objectId = currentObjectId;
+    center = QVector3D(boundingBox.center(0), boundingBox.center(1), boundingBox.center(2));
+    return true;
+}
+
+// The handles keep the same size on screen
+float TransformGizmo::handleLength() const {
+    return handleLengthPerVerticalSpan * display->getCamera()->getVerticalSpan();
+}
+
+QVector3D TransformGizmo::axis(int i) const {
+    QVector3D axis;
+    axis[i] = 1;
+    return axis;
+}
+
+QPointF TransformGizmo::toScreen(const QVector3D &point) const {
+    const QMatrix4x4 matrix = display->getCamera()->projectionMatrix() * display->getCamera()->modelViewMatrix();
+    const QVector3D normalized = matrix.map(point);
+    return QPointF((normalized.x() + 1) / 2 * display->getW(), (1 - normalized.y()) / 2 * display->getH());
+}
+
+// Line strip of handle i: the axis for moving and scaling, a circle around the axis for rotating
+QVector<QVector3D> TransformGizmo::handlePoints(int i) const {
+    QVector<QVector3D> points;
+    if (mode != Rotate) {
+        points << center << center + axis(i) * handleLength();
+        return points;
+    }
+
+    const QVector3D u = axis((i + 1) % 3);
+    const QVector3D v = axis((i + 2) % 3);
+    for (int segment = 0; segment <= circleSegments; segment++) {
+        const float angle = 2 * pi * segment / circleSegments;
+        points << center + (u * std::cos(angle) + v * std::sin(angle)) * handleLength();
+    }
+    return points;
+}
+
+float TransformGizmo::distanceToSegment(const QPointF &point, const QPointF &a, const QPointF &b) {
+    const QPointF ab = b - a;
+    const double lengthSquared = QPointF::dotProduct(ab, ab);
+    double t = lengthSquared > 0 ? QPointF::dotProduct(point - a, ab) / lengthSquared : 0;
+    t = std::max(0.0, std::min(1.0, t));
+    const QPointF difference = point - (a + ab * t);
+    return std::sqrt(QPointF::dotProduct(difference, difference));
+}
+
+void TransformGizmo::render() {
+    if (!isDragging() && !updateObject()) return;
+
+    DisplayManager *displayManager = display->getDisplayManager();
+    displayManager->saveState();
+    displayManager->setLightingEnabled(false);
+    displayManager->setDepthTestEnabled(false);
+    displayManager->setLineWidth(2);
+    // while dragging, the handles move with the object
+    if (isDragging()) displayManager->pushModelMatrix(dragTransform);
+
+    for (int i = 0; i < 3; i++) {
+        const float *color = i == dragAxis ? draggedAxisColor : axisColors[i];
+        displayManager->setFlatColor(color[0], color[1], color[2]);
+
+        const QVector<QVector3D> points = handlePoints(i);
+        QVector<float> lines;
+        for (int j = 0; j + 1 < points.size(); j++) {
+            lines << points[j].x() << points[j].y() << points[j].z();
+            lines << points[j + 1].x() << points[j + 1].y() << points[j + 1].z();
+        }
+        displayManager->drawLines(lines.constData(), lines.size() / 3);
+    }
+
+    if (isDragging()) displayManager->popModelMatrix();
+    displayManager->restoreState();
+}
+
+bool TransformGizmo::press(int x, int y) {
+    if (!updateObject()) return false;
+
+    const QPointF point(x, y);
+    float closestDistance = FLT_MAX;
+    int closestAxis = -1;
+    for (int i = 0; i < 3; i++) {
+        const QVector<QVector3D> points = handlePoints(i);
+        for (int j = 0; j + 1 < points.size(); j++) {
+            const float distance = distanceToSegment(point, toScreen(points[j]), toScreen(points[j + 1]));
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                closestAxis = i;
+            }
+        }
+    }
+    if (closestDistance > handlePickDistance) return false;
+
+    dragAxis = closestAxis;
+    pressPoint = point;
+    dragTransform.setToIdentity();
+    pathMatrix = document->getPathMatrix(document->getObjectTree()->getParent()[objectId]);
+    instanceMatrix = document->getInstanceMatrix(objectId);
+    return true;
+}
+
+void TransformGizmo::drag(int x, int y) {
+    if (!isDragging()) return;
+
+    const QVector3D dragAxisVector = axis(dragAxis);
+    const QPointF centerOnScreen = toScreen(center);
+    dragTransform.setToIdentity();
+
+    if (mode == Rotate) {
+        const double pressAngle = std::atan2(pressPoint.y() - centerOnScreen.y(), pressPoint.x() - centerOnScreen.x());
+        const double angle = std::atan2(y - centerOnScreen.y(), x - centerOnScreen.x());
+        float degrees = static_cast<float>((angle - pressAngle) * 180 / pi);
+        // the screen's y axis points down, so the angle is clockwise on screen. That is counterclockwise around
+        // the axis when the axis points at the viewer.
+        if (display->getCamera()->modelViewMatrixNoTranslate().mapVector(dragAxisVector).z() > 0) degrees = -degrees;
+        dragTransform.translate(center);
+        dragTransform.rotate(degrees, dragAxisVector);
+        dragTransform.translate(-center);
+    }
+    else {
+        // how far along the handle the cursor moved, in handle lengths
+        const QPointF axisOnScreen = toScreen(center + dragAxisVector * handleLength()) - centerOnScreen;
+        const double lengthSquared = QPointF::dotProduct(axisOnScreen, axisOnScreen);
+        if (lengthSquared < 1) return; // the axis points at the viewer
+        const float amount = static_cast<float>(QPointF::dotProduct(QPointF(x, y) - pressPoint, axisOnScreen) / lengthSquared);
+
+        if (mode == Translate) {
+            dragTransform.translate(dragAxisVector * amount * handleLength());
+        }
+        else {
+            QVector3D scale(1, 1, 1);
+            scale[dragAxis] = std::max(1 + amount, minimumScale);
+            dragTransform.translate(center);
+            dragTransform.scale(scale);
+            dragTransform.translate(-center);
+        }
+    }
+
+    document->getGeometryRenderer()->clearTransforms(objectId);
+    document->getGeometryRenderer()->setTransform(objectId, dragTransform);
+    document->getDisplayGrid()->forceRerenderAllDisplays();
+}
+
+// The drag moved the object in world coordinates. In its parent's coordinates that is
+// pathMatrix^-1 * dragTransform * pathMatrix, applied after the matrix the object already has.
+void TransformGizmo::release() {
+    if (!isDragging()) return;
+    dragAxis = -1;
+
+    document->getGeometryRenderer()->clearTransforms(objectId);
+    if (!dragTransform.isIdentity()) {
+        document->setInstanceMatrix(objectId, pathMatrix.inverted() * dragTransform * pathMatrix * instanceMatrix);
+    }
+    document->getDisplayGrid()->forceRerenderAllDisplays();
+}
@@ -0,0 +1,135 @@
+/*                B U L K P R O P E R T I E S . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2020 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file BulkProperties.cpp */
+
+#include <QColorDialog>
+#include <brlcad/Combination.h>
+#include "BulkProperties.h"
+#include "Document.h"
+#include "Globals.h"
+#include "MainWindow.h"
+#include "Utils.h"
+
+
+BulkProperties::BulkProperties(Document &document) : document(document) {
+    setObjectName("properties-BulkProperties");
+
+    countWidget = new QLabel(this);
+    countWidget->setObjectName("properties-nameWidget");
+    addWidget(countWidget);
+
+    colorButton = new QPushButton("Set Color");
+    addWidget(colorButton);
+    connect(colorButton, &QPushButton::clicked, this, [this]() {
+        setColor();
+    });
+
+    QLabel *moveTitle = new QLabel("Move");
+    moveTitle->setMargin(2);
+    addWidget(moveTitle);
+    translationRow = new DataRow(3, true, "", this);
+    addWidget(translationRow);
+    moveButton = new QPushButton("Move");
+    addWidget(moveButton);
+    connect(moveButton, &QPushButton::clicked, this, [this]() {
+        move();
+    });
+
+    getBoxLayout()->addStretch();
+}
+
+void BulkProperties::bindObjects(const QVector<int> &objectIds) {
+    this->objectIds = objectIds;
+    countWidget->setText(QString::number(objectIds.size()) + " objects selected");
+    for (QLineEdit *textBox : translationRow->getTextBoxes()) textBox->setText("0");
+}
+
+void BulkProperties::setColor() {
+    QColor selectedColor = QColorDialog::getColor(Qt::white, this);
+    if (!selectedColor.isValid()) return;
+
+    // several instances of a combination are one object, so each is edited once
+    QSet<QString> objectNames;
+    QVector<BRLCAD::Object *> newObjects;
+    for (int objectId : objectIds) {
+        const QString objectName = document.getObjectTree()->getNameMap()[objectId];
+        if (objectNames.contains(objectName)) continue;
+        objectNames.insert(objectName);
+
+        const std::shared_ptr<const BRLCAD::Object> state = document.getObjectState(objectName);
+        const BRLCAD::Combination *combination = dynamic_cast<const BRLCAD::Combination *>(state.get());
+        if (combination == nullptr) continue;
+        BRLCAD::Combination *newCombination = dynamic_cast<BRLCAD::Combination *>(combination->Clone());
+        newCombination->SetHasColor(true);
+        newCombination->SetRed(selectedColor.redF());
+        newCombination->SetGreen(selectedColor.greenF());
+        newCombination->SetBlue(selectedColor.blueF());
+        newObjects.append(newCombination);
+    }
+
+    if (newObjects.isEmpty()) {
+        Globals::mainWindow->getStatusBar()->showMessage("None of the selected objects is a combination",
+                                                         Globals::mainWindow->statusBarShortMessageDuration);
+        return;
+    }
+    document.modifyObjects(newObjects);
+    for (BRLCAD::Object *newObject : newObjects) delete newObject;
+}
+
+void BulkProperties::move() {
+    double translation[3];
+    for (int i = 0; i < 3; i++) translation[i] = translationRow->getTextBoxes()[i]->text().toDouble();
+
+    // parent combination name -> names of its selected children
+    QHash<QString, QSet<QString>> childNames;
+    for (int objectId : objectIds) {
+        const int parentObjectId = document.getObjectTree()->getParent()[objectId];
+        if (parentObjectId == 0) continue; // top objects have no matrix
+        childNames[document.getObjectTree()->getNameMap()[parentObjectId]].insert(document.getObjectTree()->getNameMap()[objectId]);
+    }
+
+    QVector<BRLCAD::Object *> newObjects;
+    for (QHash<QString, QSet<QString>>::const_iterator parent = childNames.begin(); parent != childNames.end(); ++parent) {
+        const std::shared_ptr<const BRLCAD::Object> parentState = document.getObjectState(parent.key());
+        if (dynamic_cast<const BRLCAD::Combination *>(parentState.get()) == nullptr) continue;
+        BRLCAD::Combination *combination = dynamic_cast<BRLCAD::Combination *>(parentState->Clone());
+
+        BRLCAD::Combination::TreeNode tree = combination->Tree();
+        for (const QString &childName : parent.value()) {
+            double matrix[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+            const double *leafMatrix = getLeafMatrix(tree, childName);
+            if (leafMatrix != nullptr) {
+                for (int i = 0; i < 16; i++) matrix[i] = leafMatrix[i];
+            }
+            // the matrix is row major, so this puts the translation in front of the existing transform
+            for (int i = 0; i < 3; i++) matrix[4 * i + 3] += translation[i] * matrix[15];
+            setLeafMatrix(tree, childName, matrix);
+        }
+        newObjects.append(combination);
+    }
+
+    if (newObjects.isEmpty()) {
+        Globals::mainWindow->getStatusBar()->showMessage("Top objects cannot be moved",
+                                                         Globals::mainWindow->statusBarShortMessageDuration);
+        return;
+    }
+    document.modifyObjects(newObjects);
+    for (BRLCAD::Object *newObject : newObjects) delete newObject;
+}
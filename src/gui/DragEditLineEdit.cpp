@@ -26,6 +26,10 @@ void DragEditLineEdit::mouseMoveEvent(QMouseEvent *event) {
             change = deltaY + initialTolerance;
         }
         if(abs(deltaY)>initialTolerance) {
+            if (!dragging) {
+                dragging = true;
+                emit dragStarted();
+            }
             if (abs(globalY-lastEmittedGlobalY)*100>screenHeight){
                 lastEmittedGlobalY = globalY;
                 setText(QString::number(map(change)));
@@ -47,6 +51,10 @@ void DragEditLineEdit::mousePressEvent(QMouseEvent *event) {
 
 void DragEditLineEdit::mouseReleaseEvent(QMouseEvent *event) {
     initialY = -1;
+    if (dragging) {
+        dragging = false;
+        emit dragFinished();
+    }
     QLineEdit::mouseReleaseEvent(event);
 }
 
@@ -24,6 +24,7 @@ HelpWidget::HelpWidget() : QVBoxWidget() {
            "Drag with <font style=\"color:$Color-ColorText\">Mouse Left Button</font> to rotate viewport camera<br><br>"
            "Drag with <font style=\"color:$Color-ColorText\">Mouse Right Button</font> to move viewport camera<br><br>"
            "Zoom In / Zoom Out <font style=\"color:$Color-ColorText\">Mouse Wheel</font> <br><br>"
+           "Click on an object with <font style=\"color:$Color-ColorText\">Mouse Left Button</font> to select it<br><br>"
            "<br><br>"
            "Focus camera on selected item <font style=\"color:$Color-ColorText\">F</font> <br><br>"
            "Focus camera on all visible items <font style=\"color:$Color-ColorText\">Ctrl+F</font> <br><br>"
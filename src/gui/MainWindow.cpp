@@ -46,10 +46,18 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
         openFile(QString(QCoreApplication::arguments().at(1)));
     }
     Globals::mainWindow = this;
+
+    pendingJournalRecoveries = EditJournal::orphanedJournals();
+    recoverNextJournal();
 }
 
 MainWindow::~MainWindow()
 {
+    // the loader reads the database of the document being opened
+    if (documentLoader != nullptr) {
+        documentLoader->cancel();
+        documentLoader->wait();
+    }
     for (const std::pair<const int, Document *> pair: documents){
         Document * document = pair.second;
         delete document;
@@ -124,12 +132,12 @@ void MainWindow::prepareUi() {
 
     QAction* createArb8Act = new QAction(tr("Arb8"), this);
     connect(createArb8Act, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::Arb8 * object = new BRLCAD::Arb8();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -141,12 +149,12 @@ void MainWindow::prepareUi() {
 
     QAction* createConeAct = new QAction(tr("Cone"), this);
     connect(createConeAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::Cone * object = new BRLCAD::Cone();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -161,12 +169,12 @@ void MainWindow::prepareUi() {
 
     QAction* createEllipsoidAct = new QAction(tr("Ellipsoid"), this);
     connect(createEllipsoidAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::Ellipsoid * object = new BRLCAD::Ellipsoid();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -179,12 +187,12 @@ void MainWindow::prepareUi() {
 
     QAction* createEllipticalTorusAct = new QAction(tr("EllipticalTorus"), this);
     connect(createEllipticalTorusAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::EllipticalTorus * object = new BRLCAD::EllipticalTorus();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -198,12 +206,12 @@ void MainWindow::prepareUi() {
 
     QAction* createHalfspaceAct = new QAction(tr("Halfspace"), this);
     connect(createHalfspaceAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::Halfspace * object = new BRLCAD::Halfspace();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -217,12 +225,12 @@ void MainWindow::prepareUi() {
 
     QAction* createHyperbolicCylinderAct = new QAction(tr("HyperbolicCylinder"), this);
     connect(createHyperbolicCylinderAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::HyperbolicCylinder * object = new BRLCAD::HyperbolicCylinder();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -236,12 +244,12 @@ void MainWindow::prepareUi() {
 
     QAction* createHyperboloidAct = new QAction(tr("Hyperboloid"), this);
     connect(createHyperboloidAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::Hyperboloid * object = new BRLCAD::Hyperboloid();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -256,12 +264,12 @@ void MainWindow::prepareUi() {
 
     QAction* createParabolicCylinderAct = new QAction(tr("ParabolicCylinder"), this);
     connect(createParabolicCylinderAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::ParabolicCylinder * object = new BRLCAD::ParabolicCylinder();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -276,12 +284,12 @@ void MainWindow::prepareUi() {
 
     QAction* createParaboloidAct = new QAction(tr("Paraboloid"), this);
     connect(createParaboloidAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::Paraboloid * object = new BRLCAD::Paraboloid();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -295,12 +303,12 @@ void MainWindow::prepareUi() {
 
     QAction* createParticleAct = new QAction(tr("Particle"), this);
     connect(createParticleAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::Particle * object = new BRLCAD::Particle();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -313,12 +321,12 @@ void MainWindow::prepareUi() {
 
     QAction* createTorusAct = new QAction(tr("Torus"), this);
     connect(createTorusAct, &QAction::triggered, this,[this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 
         BRLCAD::Torus * object = new BRLCAD::Torus();
         QString name = QInputDialog::getText(this,"Object Name","Enter object name");
         object->SetName(name.toUtf8());
-        documents[activeDocumentId]->getDatabase()->Add(*object);
+        documents[activeDocumentId]->addObject(*object);
         int objectId = documents[activeDocumentId]->getObjectTree()->addTopObject(name);
         documents[activeDocumentId]->getObjectTree()->changeVisibilityState(objectId,true);
         documents[activeDocumentId]->getObjectTreeWidget()->build(objectId);
@@ -330,10 +338,34 @@ void MainWindow::prepareUi() {
 
     QMenu* editMenu = menuTitleBar->addMenu(tr("&Edit"));
 
+    undoGroup = new QUndoGroup(this);
+    // a property edit that is still being previewed is applied first, so that it is what gets undone
+    QAction* undoAct = new QAction(tr("Undo"), this);
+    undoAct->setShortcuts(QKeySequence::Undo);
+    undoAct->setEnabled(false);
+    connect(undoGroup, &QUndoGroup::canUndoChanged, undoAct, &QAction::setEnabled);
+    connect(undoAct, &QAction::triggered, this, [this](){
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
+        documents[activeDocumentId]->commitPreview();
+        undoGroup->undo();
+    });
+    editMenu->addAction(undoAct);
+    QAction* redoAct = new QAction(tr("Redo"), this);
+    redoAct->setShortcuts(QKeySequence::Redo);
+    redoAct->setEnabled(false);
+    connect(undoGroup, &QUndoGroup::canRedoChanged, redoAct, &QAction::setEnabled);
+    connect(redoAct, &QAction::triggered, this, [this](){
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
+        documents[activeDocumentId]->commitPreview();
+        undoGroup->redo();
+    });
+    editMenu->addAction(redoAct);
+    editMenu->addSeparator();
+
     QAction* relativeMoveAct = new QAction("Relative move selected object", this);
     relativeMoveAct->setStatusTip(tr("Relative move selected object. Top objects cannot be moved."));
     connect(relativeMoveAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         if (documents[activeDocumentId]->getObjectTreeWidget()->currentItem() == nullptr) return;
         int objectId = documents[activeDocumentId]->getObjectTreeWidget()->currentItem()->data(0, Qt::UserRole).toInt();
         MatrixTransformWidget * matrixTransformWidget = new MatrixTransformWidget(documents[activeDocumentId],objectId, MatrixTransformWidget::Translate);
@@ -343,7 +375,7 @@ void MainWindow::prepareUi() {
     QAction* relativeScaleAct = new QAction("Relative scale selected object", this);
     relativeScaleAct->setStatusTip(tr("Relative scale selected object. Top objects cannot be scaled."));
     connect(relativeScaleAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         if (documents[activeDocumentId]->getObjectTreeWidget()->currentItem() == nullptr) return;
         int objectId = documents[activeDocumentId]->getObjectTreeWidget()->currentItem()->data(0, Qt::UserRole).toInt();
         MatrixTransformWidget * matrixTransformWidget = new MatrixTransformWidget(documents[activeDocumentId],objectId, MatrixTransformWidget::Scale);
@@ -353,7 +385,7 @@ void MainWindow::prepareUi() {
     QAction* relativeRotateAct = new QAction("Relative rotate selected object", this);
     relativeRotateAct->setStatusTip(tr("Relative rotate selected object. Top objects cannot be rotated."));
     connect(relativeRotateAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         if (documents[activeDocumentId]->getObjectTreeWidget()->currentItem() == nullptr) return;
         int objectId = documents[activeDocumentId]->getObjectTreeWidget()->currentItem()->data(0, Qt::UserRole).toInt();
         MatrixTransformWidget * matrixTransformWidget = new MatrixTransformWidget(documents[activeDocumentId],objectId, MatrixTransformWidget::Rotate);
@@ -366,7 +398,7 @@ void MainWindow::prepareUi() {
     QAction* resetViewportAct = new QAction("Reset current viewport", this);
     resetViewportAct->setStatusTip(tr("Reset to default camera orientation for the viewport and autoview to currently visible objects"));
     connect(resetViewportAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         documents[activeDocumentId]->getDisplayGrid()->resetViewPort(documents[activeDocumentId]->getDisplayGrid()->getActiveDisplayId());
     });
     viewMenu->addAction(resetViewportAct);
@@ -374,7 +406,7 @@ void MainWindow::prepareUi() {
     QAction* resetAllViewportsAct = new QAction("Reset all viewports", this);
     resetAllViewportsAct->setStatusTip(tr("Reset to default camera orientation for each viewport and autoview to visible objects"));
     connect(resetAllViewportsAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         documents[activeDocumentId]->getDisplayGrid()->resetAllViewPorts();
     });
     viewMenu->addAction(resetAllViewportsAct);
@@ -385,7 +417,7 @@ void MainWindow::prepareUi() {
     autoViewAct->setShortcut(Qt::Key_F|Qt::CTRL);
     autoViewAct->setStatusTip(tr("Resize and center the view based on the current visible objects"));
     connect(autoViewAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         for(Display * display : documents[activeDocumentId]->getDisplayGrid()->getDisplays()){
             display->getCamera()->autoview();
             display->forceRerenderFrame();
@@ -396,7 +428,7 @@ void MainWindow::prepareUi() {
     QAction* autoViewSingleAct = new QAction(tr("Focus visible objects (current viewport)"), this);
     autoViewSingleAct->setStatusTip(tr("Resize and center the view based on the current visible objects"));
     connect(autoViewSingleAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         documents[activeDocumentId]->getDisplay()->getCamera()->autoview();
         documents[activeDocumentId]->getDisplay()->forceRerenderFrame();
     });
@@ -406,7 +438,7 @@ void MainWindow::prepareUi() {
     centerViewAct->setStatusTip(tr("Resize and center the view based on the selected objects"));
     centerViewAct->setShortcut(Qt::Key_F);
     connect(centerViewAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         if (documents[activeDocumentId]->getObjectTreeWidget()->currentItem() == nullptr) return;
         int objectId = documents[activeDocumentId]->getObjectTreeWidget()->currentItem()->data(0, Qt::UserRole).toInt();
         documents[activeDocumentId]->getDisplay()->getCamera()->centerView(objectId);
@@ -426,7 +458,7 @@ void MainWindow::prepareUi() {
         singleViewAct[i]->setCheckable(true);
         singleViewAct[i]->setStatusTip("Display viewport " + QString::number(i+1));
         connect(singleViewAct[i], &QAction::triggered, this, [this,i]() {
-            if (activeDocumentId == -1) return;
+            if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
             documents[activeDocumentId]->getDisplayGrid()->singleDisplayMode(i);
             currentViewport->setCurrentIndex(i);
         });
@@ -441,7 +473,7 @@ void MainWindow::prepareUi() {
     QAction* quadViewAct = new QAction(tr("All Viewports"), this);
     quadViewAct->setStatusTip(tr("Display 4 viewports"));
     connect(quadViewAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         documents[activeDocumentId]->getDisplayGrid()->quadDisplayMode();
         for(QAction *i : singleViewAct) i->setChecked(false);
         currentViewport->setCurrentIndex(4);
@@ -454,13 +486,37 @@ void MainWindow::prepareUi() {
     QAction* toggleGridAct = new QAction(tr("Toggle grid on/off"), this);
     toggleGridAct->setShortcut(Qt::Key_G);
     connect(toggleGridAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         documents[activeDocumentId]->getDisplayGrid()->getActiveDisplay()->gridEnabled = 
                 !documents[activeDocumentId]->getDisplayGrid()->getActiveDisplay()->gridEnabled;
         documents[activeDocumentId]->getDisplayGrid()->getActiveDisplay()->forceRerenderFrame();
     });
     viewMenu->addAction(toggleGridAct);
 
+    QAction* shadedModeAct = new QAction(tr("Shaded mode"), this);
+    shadedModeAct->setStatusTip(tr("Display solids as shaded triangle meshes instead of wireframes"));
+    shadedModeAct->setCheckable(true);
+    shadedModeAct->setChecked(QSettings("BRLCAD", "arbalest").value("shadedMode", false).toBool());
+    connect(shadedModeAct, &QAction::toggled, this, [this](bool checked){
+        QSettings settings("BRLCAD", "arbalest");
+        settings.setValue("shadedMode", checked);
+        for (const std::pair<const int, Document *> pair : documents) {
+            pair.second->getGeometryRenderer()->setShaded(checked);
+            pair.second->getDisplayGrid()->forceRerenderAllDisplays();
+        }
+    });
+    viewMenu->addAction(shadedModeAct);
+
+    QAction* cpuPickingAct = new QAction(tr("Use CPU picking"), this);
+    cpuPickingAct->setStatusTip(tr("Select objects by intersecting a ray with their bounding boxes and confirming with the raytracer, instead of reading back from the GPU"));
+    cpuPickingAct->setCheckable(true);
+    cpuPickingAct->setChecked(QSettings("BRLCAD", "arbalest").value("cpuPicking", false).toBool());
+    connect(cpuPickingAct, &QAction::toggled, this, [](bool checked){
+        QSettings settings("BRLCAD", "arbalest");
+        settings.setValue("cpuPicking", checked);
+    });
+    viewMenu->addAction(cpuPickingAct);
+
 
     QMenu* selectThemeAct = viewMenu->addMenu(tr("Select theme"));
     QActionGroup *selectThemeActGroup = new QActionGroup(this);
@@ -494,7 +550,7 @@ void MainWindow::prepareUi() {
     raytraceAct->setStatusTip(tr("Raytrace current viewport"));
     raytraceAct->setShortcut(Qt::CTRL|Qt::Key_R);
     connect(raytraceAct, &QAction::triggered, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         statusBar->showMessage("Raytracing current viewport...", statusBarShortMessageDuration);
         QCoreApplication::processEvents();
         documents[activeDocumentId]->getRaytraceWidget()->raytrace();
@@ -574,6 +630,12 @@ void MainWindow::prepareUi() {
     statusBarPathLabel = new QLabel("No document open");
     statusBarPathLabel->setObjectName("statusBarPathLabel");
     statusBar->addWidget(statusBarPathLabel);
+    cancelLoadingButton = new QPushButton(tr("Cancel"));
+    cancelLoadingButton->hide();
+    statusBar->addPermanentWidget(cancelLoadingButton);
+    connect(cancelLoadingButton, &QPushButton::clicked, this, [this](){
+        if (documentLoader != nullptr) documentLoader->cancel();
+    });
 	
 
     // Document area --------------------------------------------------------------------------------------------------------
@@ -625,7 +687,7 @@ void MainWindow::prepareUi() {
     focusAll->setObjectName("toolbarButton");
     focusAll->setToolTip("Focus on all visible objects (Ctrl+F)");
     connect(focusAll, &QPushButton::clicked, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         for(Display * display : documents[activeDocumentId]->getDisplayGrid()->getDisplays()){
             display->getCamera()->autoview();
             display->forceRerenderFrame();
@@ -638,7 +700,7 @@ void MainWindow::prepareUi() {
     focusCurrent->setObjectName("toolbarButton");
     focusCurrent->setToolTip("Focus on selected object (F)");
     connect(focusCurrent, &QPushButton::clicked, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         if (documents[activeDocumentId]->getObjectTreeWidget()->currentItem() == nullptr) return;
         int objectId = documents[activeDocumentId]->getObjectTreeWidget()->currentItem()->data(0, Qt::UserRole).toInt();
         documents[activeDocumentId]->getDisplay()->getCamera()->centerView(objectId);
@@ -651,7 +713,7 @@ void MainWindow::prepareUi() {
     resetViewports->setObjectName("toolbarButton");
     resetViewports->setToolTip("Reset the viewports and focus on the visible");
     connect(resetViewports, &QPushButton::clicked, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         documents[activeDocumentId]->getDisplayGrid()->resetAllViewPorts();
     });
     mainTabBarCornerWidget->addWidget(resetViewports);
@@ -664,7 +726,7 @@ void MainWindow::prepareUi() {
     currentViewport->addItem("All Viewports");
     currentViewport->setCurrentIndex(3);
     connect(currentViewport, QOverload<int>::of(&QComboBox::activated),[=](int index){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         if (index <4) documents[activeDocumentId]->getDisplayGrid()->singleDisplayMode(index);
         else documents[activeDocumentId]->getDisplayGrid()->quadDisplayMode();
         for(QAction *i : singleViewAct) i->setChecked(false);
@@ -679,7 +741,7 @@ void MainWindow::prepareUi() {
     toggleGrid->setObjectName("toolbarButton");
     toggleGrid->setToolTip("Toggle grid on/off (G)");
     connect(toggleGrid, &QPushButton::clicked, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         documents[activeDocumentId]->getDisplayGrid()->getActiveDisplay()->gridEnabled =
                 !documents[activeDocumentId]->getDisplayGrid()->getActiveDisplay()->gridEnabled;
         documents[activeDocumentId]->getDisplayGrid()->getActiveDisplay()->forceRerenderFrame();
@@ -694,7 +756,7 @@ void MainWindow::prepareUi() {
     raytraceButton->setToolTip("Raytrace current viewport (Ctrl+R)");
     mainTabBarCornerWidget->addWidget(raytraceButton);
     connect(raytraceButton, &QPushButton::clicked, this, [this](){
-        if (activeDocumentId == -1) return;
+        if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
         statusBar->showMessage("Raytracing current viewport...", statusBarShortMessageDuration);
         QCoreApplication::processEvents();
         documents[activeDocumentId]->getRaytraceWidget()->raytrace();
@@ -726,47 +788,170 @@ void MainWindow::prepareDockables(){
 // empty new file
 void MainWindow::newFile() {
     Document* document = new Document(documentsCount);
-    document->getObjectTreeWidget()->setObjectName("dockableContent");
+    document->getObjectTreePanel()->setObjectName("dockableContent");
     document->getProperties()->setObjectName("dockableContent");
     documents[documentsCount++] = document;
+    undoGroup->addStack(document->getUndoStack());
     QString filename( "Untitled");
     const int tabIndex = documentArea->addTab(document->getDisplayGrid(), filename);
     documentArea->setCurrentIndex(tabIndex);
     connect(documents[activeDocumentId]->getObjectTreeWidget(), &ObjectTreeWidget::selectionChanged,
             this, &MainWindow::objectTreeWidgetSelectionChanged);
+    connect(documents[activeDocumentId]->getObjectTreeWidget(), &ObjectTreeWidget::objectsSelectionChanged,
+            this, &MainWindow::objectTreeWidgetObjectsSelectionChanged);
     
 }
 
 void MainWindow::openFile(const QString& filePath) {
-    Document* document = nullptr;
-
-    try {
-        document = new Document(documentsCount, &filePath);
+    if (documentLoader != nullptr) {
+        statusBar->showMessage("Wait until " + documentLoader->getFilePath() + " is opened", statusBarShortMessageDuration);
+        return;
     }
-    catch (...) {
-        QString msg = "Failed to open " + filePath;
-        statusBar->showMessage(msg, statusBarShortMessageDuration);
 
-        QMessageBox msgBox;
-        msgBox.setText(msg);
-        msgBox.exec();
-    }
+    const QString filename(QFileInfo(filePath).fileName());
+    documentLoader = new DocumentLoader(filePath);
+    loadingDocumentId = -1;
+    loadedTopObjectCount = 0;
+    topObjectCount = 0;
 
-    if (document != nullptr) {
-        document->getObjectTreeWidget()->setObjectName("dockableContent");
+    connect(documentLoader, &DocumentLoader::opened, this, [this, filePath, filename](BRLCAD::ConstDatabase *database, int topObjectCount){
+        Document *document = new Document(documentsCount, &filePath, database);
+        document->setLoading(true);
+        document->getObjectTreePanel()->setObjectName("dockableContent");
         document->getProperties()->setObjectName("dockableContent");
+        loadingDocumentId = documentsCount;
+        this->topObjectCount = topObjectCount;
         documents[documentsCount++] = document;
-        QString filename(QFileInfo(filePath).fileName());
+        undoGroup->addStack(document->getUndoStack());
         const int tabIndex = documentArea->addTab(document->getDisplayGrid(), filename);
         documentArea->setCurrentIndex(tabIndex);
-        connect(documents[activeDocumentId]->getObjectTreeWidget(), &ObjectTreeWidget::selectionChanged,
+        connect(document->getObjectTreeWidget(), &ObjectTreeWidget::selectionChanged,
                 this, &MainWindow::objectTreeWidgetSelectionChanged);
+        connect(document->getObjectTreeWidget(), &ObjectTreeWidget::objectsSelectionChanged,
+                this, &MainWindow::objectTreeWidgetObjectsSelectionChanged);
+    });
+
+    connect(documentLoader, &DocumentLoader::fragmentLoaded, this, [this, filename](ObjectTree::Fragment *fragment){
+        if (loadingDocumentId != -1) {
+            Document *document = documents[loadingDocumentId];
+            const int objectId = document->getObjectTree()->addFragment(*fragment);
+            document->getObjectTreeWidget()->build(objectId);
+            loadedTopObjectCount++;
+            statusBar->showMessage("Opening " + filename + ": " + QString::number(loadedTopObjectCount) + " / " + QString::number(topObjectCount) + " top objects");
+        }
+        delete fragment;
+    });
+
+    connect(documentLoader, &DocumentLoader::failed, this, [this, filePath](){
+        QString msg = "Failed to open " + filePath;
+        statusBar->showMessage(msg, statusBarShortMessageDuration);
+
+        QMessageBox msgBox;
+        msgBox.setText(msg);
+        msgBox.exec();
+    });
+
+    connect(documentLoader, &DocumentLoader::finished, this, [this, filename](bool canceled){
+        documentLoader = nullptr;
+        cancelLoadingButton->hide();
+        if (loadingDocumentId == -1) {
+            if (canceled) statusBar->showMessage("Canceled opening " + filename, statusBarShortMessageDuration);
+            recoveringJournal.clear();
+            recoverNextJournal();
+            return;
+        }
+
+        Document *document = documents[loadingDocumentId];
+        loadingDocumentId = -1;
+        document->setLoading(false);
+        if (canceled) {
+            const int tabIndex = documentArea->indexOf(document->getDisplayGrid());
+            if (tabIndex != -1) tabCloseRequested(tabIndex);
+            statusBar->showMessage("Canceled opening " + filename, statusBarShortMessageDuration);
+            recoveringJournal.clear();
+            recoverNextJournal();
+            return;
+        }
+        document->getObjectTreeWidget()->refreshItemTextColors();
+        statusBar->showMessage("Opened " + filename, statusBarShortMessageDuration);
+
+        if (!recoveringJournal.isEmpty()) {
+            if (EditJournal::replay(recoveringJournal, document)) EditJournal::remove(recoveringJournal);
+            recoveringJournal.clear();
+        }
+        recoverNextJournal();
+    });
+
+    statusBar->showMessage("Opening " + filename + "...");
+    cancelLoadingButton->show();
+    documentLoader->start();
+}
+
+void MainWindow::saveFile(const QString& filePath) {
+    if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
+    Document *document = documents[activeDocumentId];
+    document->commitPreview();
+    if (document->isSaving()) {
+        statusBar->showMessage("Saving is in progress", statusBarShortMessageDuration);
+        return;
     }
+
+    DocumentSaver *documentSaver = new DocumentSaver(document, filePath);
+    document->setSaving(true);
+    statusBar->showMessage("Saving to " + filePath + "...");
+
+    connect(documentSaver, &DocumentSaver::finished, this, [this, document, filePath](bool success, const QStringList &objectNames){
+        document->setSaving(false);
+        if (!success) {
+            // keep them for the next save. The journal still holds them and its base file was not replaced.
+            for (const QString &objectName : objectNames) document->getModifiedObjectNames().insert(objectName);
+            statusBar->showMessage("Failed to save to " + filePath, statusBarShortMessageDuration);
+            return;
+        }
+        document->getJournal()->saved(filePath, !document->getModifiedObjectNames().isEmpty());
+
+        if (document->getFilePath() == nullptr || *document->getFilePath() != filePath) {
+            document->setFilePath(filePath);
+            const int tabIndex = documentArea->indexOf(document->getDisplayGrid());
+            if (tabIndex != -1) documentArea->setTabText(tabIndex, QFileInfo(filePath).fileName());
+            if (document->getDocumentId() == activeDocumentId) statusBarPathLabel->setText(filePath);
+        }
+        document->getTessellator()->saved(objectNames);
+        statusBar->showMessage("Saved to " + filePath, statusBarShortMessageDuration);
+    });
+    documentSaver->start();
 }
 
-bool MainWindow::saveFile(const QString& filePath) {
-    if (activeDocumentId == -1) return false;
-    return documents[activeDocumentId]->getDatabase()->Save(filePath.toUtf8().data());
+// Offers to recover the edits of documents that were open when arbalest crashed. Documents with a file are opened
+// first and the journal is replayed once they finish loading.
+void MainWindow::recoverNextJournal() {
+    while (documentLoader == nullptr && !pendingJournalRecoveries.isEmpty()) {
+        const QString directory = pendingJournalRecoveries.takeFirst();
+        QString baseFilePath;
+        QStringList objectNames;
+        if (!EditJournal::read(directory, baseFilePath, objectNames) || objectNames.isEmpty()) {
+            EditJournal::remove(directory);
+            continue;
+        }
+
+        const QString documentName = baseFilePath.isEmpty() ? "an untitled document" : baseFilePath;
+        const QMessageBox::StandardButton answer = QMessageBox::question(this, "Recover Unsaved Edits",
+                "Arbalest was closed unexpectedly with unsaved edits to " + QString::number(objectNames.size()) +
+                " objects of " + documentName + ". Do you want to recover them?", QMessageBox::Yes | QMessageBox::No);
+        if (answer != QMessageBox::Yes) {
+            EditJournal::remove(directory);
+            continue;
+        }
+
+        if (baseFilePath.isEmpty()) {
+            newFile();
+            if (EditJournal::replay(directory, documents[activeDocumentId])) EditJournal::remove(directory);
+            continue;
+        }
+
+        recoveringJournal = directory;
+        openFile(baseFilePath);
+    }
 }
 
 void MainWindow::openFileDialog()
@@ -778,30 +963,20 @@ void MainWindow::openFileDialog()
 }
 
 void MainWindow::saveAsFileDialog() {
-    if (activeDocumentId == -1) return;
+    if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
 	const QString filePath = QFileDialog::getSaveFileName(this, tr("Save BRL-CAD database"), QString(), "BRL-CAD Database (*.g)");
     if (!filePath.isEmpty()) {
-        if (saveFile(filePath))
-        {
-            documents[activeDocumentId]->setFilePath(filePath);
-            QString filename(QFileInfo(filePath).fileName());
-            documentArea->setTabText(documentArea->currentIndex(), filename);
-            statusBarPathLabel->setText(*documents[activeDocumentId]->getFilePath());
-            statusBar->showMessage("Saved to " + filePath, statusBarShortMessageDuration);
-        }
+        saveFile(filePath);
     }
 }
 
 void MainWindow::saveFileDefaultPath() {
-    if (activeDocumentId == -1) return;
+    if (activeDocumentId == -1 || documents[activeDocumentId]->isLoading()) return;
     if (documents[activeDocumentId]->getFilePath() == nullptr) saveAsFileDialog();
     else {
         const QString filePath = *documents[activeDocumentId]->getFilePath();
         if (!filePath.isEmpty()) {
-            if (saveFile(filePath))
-            {
-                statusBar->showMessage("Saved to " + filePath, statusBarShortMessageDuration);
-            }
+            saveFile(filePath);
         }
     }
 }
@@ -810,7 +985,8 @@ void MainWindow::onActiveDocumentChanged(const int newIndex){
     DisplayGrid * displayGrid = dynamic_cast<DisplayGrid*>(documentArea->widget(newIndex));
     if (displayGrid != nullptr && displayGrid->getDocument()->getDocumentId() != activeDocumentId){
         activeDocumentId = displayGrid->getDocument()->getDocumentId();
-        objectTreeWidgetDockable->setContent(documents[activeDocumentId]->getObjectTreeWidget());
+        undoGroup->setActiveStack(documents[activeDocumentId]->getUndoStack());
+        objectTreeWidgetDockable->setContent(documents[activeDocumentId]->getObjectTreePanel());
         objectPropertiesDockable->setContent(documents[activeDocumentId]->getProperties());
         statusBarPathLabel->setText(documents[activeDocumentId]->getFilePath()  != nullptr ? *documents[activeDocumentId]->getFilePath() : "Untitled");
 
@@ -828,10 +1004,15 @@ void MainWindow::onActiveDocumentChanged(const int newIndex){
 
 void MainWindow::tabCloseRequested(const int i)
 {
+    DisplayGrid * displayGrid = dynamic_cast<DisplayGrid*>(documentArea->widget(i));
+    if (displayGrid != nullptr && documentLoader != nullptr && displayGrid->getDocument()->getDocumentId() == loadingDocumentId) {
+        documentLoader->cancel();
+    }
     documentArea->removeTab(i);
     if (documentArea->currentIndex() == -1){
         objectTreeWidgetDockable->clear();
         objectPropertiesDockable->clear();
+        undoGroup->setActiveStack(nullptr);
         activeDocumentId = -1;
         documentArea->addTab(new HelpWidget(), "Quick Start");
     }
@@ -841,6 +1022,10 @@ void MainWindow::objectTreeWidgetSelectionChanged(int objectId) {
     documents[activeDocumentId]->getProperties()->bindObject(objectId);
 }
 
+void MainWindow::objectTreeWidgetObjectsSelectionChanged(QVector<int> objectIds) {
+    documents[activeDocumentId]->getProperties()->bindObjects(objectIds);
+}
+
 void MainWindow::closeButtonPressed(){
     close();
 }
@@ -2,16 +2,21 @@
 #include <brlcad/Object.h>
 #include <brlcad/Combination.h>
 #include <QMessageBox>
+#include <QCloseEvent>
 #include "MatrixTransformWidget.h"
+#include "DragEditLineEdit.h"
 
 QHash<int,QWidget*> MatrixTransformWidget::widgets;
 
 MatrixTransformWidget::MatrixTransformWidget(Document *document, int childObjectId, TransformType transformType)
-        : DataRow(3, true) {
+        : DataRow(3, true), document(document), childObjectId(childObjectId), transformType(transformType) {
     setWindowFlags( Qt::Window| Qt::WindowCloseButtonHint);
     setAttribute( Qt::WA_QuitOnClose, false );
-    QString parentObjectName = document->getObjectTree()->getNameMap()[document->getObjectTree()->getParent()[childObjectId]];
-    QString childNodeName = document->getObjectTree()->getNameMap()[childObjectId];
+    setAttribute( Qt::WA_DeleteOnClose );
+    ObjectTree *objectTree = document->getObjectTree();
+    const int parentObjectId = objectTree->getParent()[childObjectId];
+    QString parentObjectName = objectTree->getNameMap()[parentObjectId];
+    QString childNodeName = objectTree->getNameMap()[childObjectId];
     setWindowTitle(childNodeName);
     if (parentObjectName == ""){
         QMessageBox::information(this, "Can't Transform Top Object", "You cannot transform top objects", QMessageBox::Ok);
@@ -26,57 +31,97 @@ MatrixTransformWidget::MatrixTransformWidget(Document *document, int childObject
     if(widgets.contains(childObjectId)) widgets[childObjectId]->close();
     widgets[childObjectId] = this;
 
-    double *transformationMatrix = new double[16]{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
-    getBRLCADObject(document->getDatabase(), parentObjectName, [this, childNodeName, transformationMatrix](BRLCAD::Object &object) {
-        BRLCAD::Combination::TreeNode tree = dynamic_cast<BRLCAD::Combination *>(&object)->Tree();
-        const double *transformationMatrixPtr = getLeafMatrix(tree, childNodeName);
-        if (transformationMatrixPtr != nullptr) {
-            for(int i=0;i<16;i++)transformationMatrix[i] = transformationMatrixPtr[i];
-        }
-    });
+    // the parent is read and its leaf looked up once. Edits change this copy of the leaf for the preview only.
+    const std::shared_ptr<const BRLCAD::Object> parentState = document->getObjectState(parentObjectName);
+    if (parentState != nullptr) parentObject = dynamic_cast<BRLCAD::Combination *>(parentState->Clone());
+    bool hasLeaf = false;
+    if (parentObject != nullptr) {
+        BRLCAD::Combination::TreeNode tree = parentObject->Tree();
+        hasLeaf = findLeaf(tree, childNodeName, leaf);
+    }
+    if (hasLeaf && leaf.Matrix() != nullptr) {
+        for (int i = 0; i < 16; i++) initialMatrix[i] = leaf.Matrix()[i];
+    }
+    for (int i = 0; i < 16; i++) appliedMatrix[i] = initialMatrix[i];
+
+    parentToWorld = document->getPathMatrix(parentObjectId);
 
     for (int i = 0; i < 3; i++) {
         getTextBoxes()[i]->setText("0");
         if(transformType == Scale) getTextBoxes()[i]->setText("1");
+        getTextBoxes()[i]->setEnabled(hasLeaf);
 
-        connect(getTextBoxes()[i], &QLineEdit::textEdited, this, [transformType, this,transformationMatrix,document,parentObjectName,childObjectId, childNodeName ]() {
-            double change[3];
-            change[0] = getTextBoxes()[0]->text().toDouble();
-            change[1] = getTextBoxes()[1]->text().toDouble();
-            change[2] = getTextBoxes()[2]->text().toDouble();
+        connect(getTextBoxes()[i], &QLineEdit::textEdited, this, [this]() {
+            edit();
+        });
+        connect(getTextBoxes()[i], &QLineEdit::editingFinished, this, [this]() {
+            apply();
+        });
+        DragEditLineEdit *dragEditLineEdit = qobject_cast<DragEditLineEdit *>(getTextBoxes()[i]);
+        if (dragEditLineEdit != nullptr) {
+            connect(dragEditLineEdit, &DragEditLineEdit::dragFinished, this, [this]() {
+                apply();
+            });
+        }
+    }
 
-            QMatrix4x4 m = QMatrix4x4(transformationMatrix[0], transformationMatrix[1], transformationMatrix[2], transformationMatrix[3],
-                                      transformationMatrix[4], transformationMatrix[5], transformationMatrix[6], transformationMatrix[7],
-                                      transformationMatrix[8], transformationMatrix[9], transformationMatrix[10], transformationMatrix[11],
-                                      transformationMatrix[12], transformationMatrix[13], transformationMatrix[14], transformationMatrix[15]).transposed();
+    show();
+}
 
-            if(transformType == Translate) {
-                m.translate(change[0], change[1], change[2]);
-            }
-            if(transformType == Scale) {
-                m.scale(change[0], change[1], change[2]);
-            }
-            if(transformType == Rotate){
-                double degToRad = 0.01745329252;
-                m.rotate(change[0]*degToRad, QVector3D(1.f,0.f,0.f));
-                m.rotate(change[1]*degToRad, QVector3D(0.f,1.f,0.f));
-                m.rotate(change[2]*degToRad, QVector3D(0.f,0.f,1.f));
-            }
+MatrixTransformWidget::~MatrixTransformWidget() {
+    if (widgets.value(childObjectId) == this) widgets.remove(childObjectId);
+    document->getGeometryRenderer()->clearTransforms(childObjectId);
+    delete parentObject;
+}
 
-            m = m.transposed();
+void MatrixTransformWidget::closeEvent(QCloseEvent *event) {
+    apply();
+    DataRow::closeEvent(event);
+}
 
-            double *newTransformationMatrix = new double[16]{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, .5};
+// Sets the new matrix on the leaf and moves the already plotted solids by the difference to the applied one
+void MatrixTransformWidget::edit() {
+    double change[3];
+    change[0] = getTextBoxes()[0]->text().toDouble();
+    change[1] = getTextBoxes()[1]->text().toDouble();
+    change[2] = getTextBoxes()[2]->text().toDouble();
 
-            for (int i = 0; i < 16; ++i) newTransformationMatrix[i] = m.data()[i];
+    QMatrix4x4 m = toQMatrix4x4(initialMatrix);
 
+    if(transformType == Translate) {
+        m.translate(change[0], change[1], change[2]);
+    }
+    if(transformType == Scale) {
+        m.scale(change[0], change[1], change[2]);
+    }
+    if(transformType == Rotate){
+        double degToRad = 0.01745329252;
+        m.rotate(change[0]*degToRad, QVector3D(1.f,0.f,0.f));
+        m.rotate(change[1]*degToRad, QVector3D(0.f,1.f,0.f));
+        m.rotate(change[2]*degToRad, QVector3D(0.f,0.f,1.f));
+    }
 
-            getBRLCADObject(document->getDatabase(), parentObjectName, [this, childNodeName,childObjectId, newTransformationMatrix,document](BRLCAD::Object &object) {
-                BRLCAD::Combination::TreeNode tree = dynamic_cast<BRLCAD::Combination *>(&object)->Tree();
-                setLeafMatrix(tree, childNodeName, newTransformationMatrix);
-            });
-            document->modifyObjectNoSet(document->getObjectTree()->getParent()[childObjectId]);
-        });
+    double newTransformationMatrix[16];
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 4; column++) newTransformationMatrix[4 * row + column] = m(row, column);
     }
+    leaf.SetMatrix(newTransformationMatrix);
+    edited = true;
 
-    show();
+    const QMatrix4x4 transform = parentToWorld * m * toQMatrix4x4(appliedMatrix).inverted() * parentToWorld.inverted();
+    document->getGeometryRenderer()->clearTransforms(childObjectId);
+    document->getGeometryRenderer()->setTransform(childObjectId, transform);
+    document->getDisplayGrid()->forceRerenderAllDisplays();
+}
+
+// Sets the edited matrix on the current state of the parent, which re-plots the solids at their new place.
+// Changes made to the parent since the window was opened (other children, colors, undo) are kept.
+void MatrixTransformWidget::apply() {
+    if (!edited) return;
+    edited = false;
+
+    document->getGeometryRenderer()->clearTransforms(childObjectId);
+    if (leaf.Matrix() == nullptr) return;
+    document->setInstanceMatrix(childObjectId, toQMatrix4x4(leaf.Matrix()));
+    for (int i = 0; i < 16; i++) appliedMatrix[i] = leaf.Matrix()[i];
 }
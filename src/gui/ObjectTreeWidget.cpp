@@ -43,6 +43,7 @@ ObjectTreeWidget::ObjectTreeWidget(Document* document, QWidget* parent) : docume
 	this->setHeaderHidden(true);
 	setColumnCount(1);
 	setMouseTracking(true);
+	setSelectionMode(QAbstractItemView::ExtendedSelection);
 
 	build(0);
 
@@ -50,9 +51,25 @@ ObjectTreeWidget::ObjectTreeWidget(Document* document, QWidget* parent) : docume
     setItemDelegateForColumn(0, visibilityButton);
 
     connect(this,&QTreeWidget::currentItemChanged,this,[this](QTreeWidgetItem *current, QTreeWidgetItem *previous){
-        selectionChanged (current->data(0, Qt::UserRole).toInt());
+        if (current == nullptr) return; // the current item was removed
         // Qt changes foreground color for selected items. We don't want it changed
         setStyleSheet("ObjectTreeWidget::item:selected { color: "+current->foreground(0).color().name()+";}");
+        if (selectedItems().size() > 1) return;
+        selectionChanged (current->data(0, Qt::UserRole).toInt());
+    });
+    connect(this,&QTreeWidget::itemSelectionChanged,this,[this](){
+        const QList<QTreeWidgetItem*> items = selectedItems();
+        if (items.size() > 1) {
+            multipleSelected = true;
+            QVector<int> objectIds;
+            for (QTreeWidgetItem *item : items) objectIds.append(item->data(0, Qt::UserRole).toInt());
+            objectsSelectionChanged(objectIds);
+        }
+        // going back to one selected item does not always change the current item (ex: clicking the current one)
+        else if (items.size() == 1 && multipleSelected) {
+            multipleSelected = false;
+            selectionChanged(items[0]->data(0, Qt::UserRole).toInt());
+        }
     });
     connect(visibilityButton, &ObjectTreeRowButtons::visibilityButtonClicked, this, [this](int objectId){
         switch(this->document->getObjectTree()->getObjectVisibility()[objectId]){
@@ -100,6 +117,89 @@ void ObjectTreeWidget::build(const int objectId, QTreeWidgetItem* parent)
 	}
 }
 
+void ObjectTreeWidget::applyDelta(const ObjectTree::Delta& delta)
+{
+    QSet<int> removedObjectIds;
+    for (int objectId : delta.removedObjectIds) removedObjectIds.insert(objectId);
+
+    // deleting an item deletes its children, so only the roots of the removed subtrees are deleted
+    QVector<QTreeWidgetItem*> removedItems;
+    for (int objectId : delta.removedObjectIds) {
+        QTreeWidgetItem* item = objectIdTreeWidgetItemMap.take(objectId);
+        if (item == nullptr) continue;
+        if (item->parent() == nullptr || !removedObjectIds.contains(item->parent()->data(0, Qt::UserRole).toInt())) {
+            removedItems.append(item);
+        }
+    }
+    for (QTreeWidgetItem* item : removedItems) delete item;
+
+    for (int objectId : delta.addedObjectIds) {
+        const int parentObjectId = document->getObjectTree()->getParent()[objectId];
+        build(objectId, objectIdTreeWidgetItemMap.value(parentObjectId, nullptr));
+    }
+
+    // the kept and added children are put in the order of the combination's tree
+    for (int objectId : delta.changedObjectIds) {
+        QTreeWidgetItem* item = objectIdTreeWidgetItemMap.value(objectId, nullptr);
+        if (item == nullptr) continue;
+        item->takeChildren();
+        for (int childObjectId : document->getObjectTree()->getChildren()[objectId]) {
+            item->addChild(objectIdTreeWidgetItemMap[childObjectId]);
+        }
+    }
+
+    if (!filterText.isEmpty()) filter(filterText);
+}
+
+// Only the items on the paths to the matches and their siblings are visited, not the whole tree
+void ObjectTreeWidget::filter(const QString& text)
+{
+    filterText = text;
+    for (int objectId : hiddenObjectIds) {
+        QTreeWidgetItem* item = objectIdTreeWidgetItemMap.value(objectId, nullptr);
+        if (item != nullptr) item->setHidden(false);
+    }
+    hiddenObjectIds.clear();
+    if (text.isEmpty()) return;
+
+    ObjectTree* objectTree = document->getObjectTree();
+    QSet<int> matchedObjectIds;
+    QSet<int> shownObjectIds;
+    for (int objectId : objectTree->findObjects(text)) {
+        matchedObjectIds.insert(objectId);
+        for (int id = objectId; id > 0 && !shownObjectIds.contains(id); id = objectTree->getParent()[id]) {
+            shownObjectIds.insert(id);
+        }
+    }
+
+    // the children of matches stay visible, so only the root and the ancestors of matches hide children
+    QVector<int> parentObjectIds = {0};
+    for (int objectId : shownObjectIds) {
+        if (!matchedObjectIds.contains(objectId)) parentObjectIds.append(objectId);
+    }
+    for (int parentObjectId : parentObjectIds) {
+        if (parentObjectId != 0) objectIdTreeWidgetItemMap[parentObjectId]->setExpanded(true);
+        for (int childObjectId : objectTree->getChildren()[parentObjectId]) {
+            if (shownObjectIds.contains(childObjectId)) continue;
+            objectIdTreeWidgetItemMap[childObjectId]->setHidden(true);
+            hiddenObjectIds.append(childObjectId);
+        }
+    }
+}
+
+// Makes objectId the current item (which emits selectionChanged) and reveals it in the tree
+void ObjectTreeWidget::selectObject(const int objectId)
+{
+    QTreeWidgetItem* item = objectIdTreeWidgetItemMap.value(objectId, nullptr);
+    if (item == nullptr) return;
+
+    for (QTreeWidgetItem* ancestor = item->parent(); ancestor != nullptr; ancestor = ancestor->parent()) {
+        ancestor->setExpanded(true);
+    }
+    setCurrentItem(item);
+    scrollToItem(item);
+}
+
 const QHash<int, QTreeWidgetItem *> &ObjectTreeWidget::getObjectIdTreeWidgetItemMap() const {
     return objectIdTreeWidgetItemMap;
 }
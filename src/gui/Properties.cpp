@@ -2,6 +2,7 @@
 #include <include/CollapsibleWidget.h>
 #include "Properties.h"
 #include "TypeSpecificProperties.h"
+#include "BulkProperties.h"
 #include <Globals.h>
 #include <iostream>
 #include "Utils.h"
@@ -18,29 +19,103 @@ Properties::Properties(Document & document) : document(document) {
 
     typeSpecificPropertiesArea = new QVBoxWidget(this);
 
+    bulkProperties = new BulkProperties(document);
+    bulkProperties->hide();
+
     layout()->addWidget(nameWidget);
     layout()->addWidget(fullPathWidget);
     layout()->addWidget(typeSpecificPropertiesArea);
+    layout()->addWidget(bulkProperties);
     getBoxLayout()->addStretch();
 }
 
+Properties::~Properties() {
+    delete object;
+}
+
 
 void Properties::bindObject(const int objectId) {
-    this->fullPath = document.getObjectTree()->getFullPathMap()[objectId];
+    document.commitPreview(); // the pending edit belongs to the object that is about to be deleted
+    this->objectId = objectId;
+    objectIds.clear();
+    bulkProperties->hide();
+    nameWidget->show();
+    fullPathWidget->show();
+    typeSpecificPropertiesArea->show();
+    this->fullPath = document.getObjectTree()->getFullPathMap().value(objectId);
     this->name = fullPath.split("/").last();
     fullPathWidget->setText(QString(fullPath).replace("/"," / "));
 
-    static BRLCAD::Object* object = nullptr;
-    delete object;
-	object = document.getDatabase()->Get(fullPath.toUtf8().data());
-    objectType = QString(object->Type());
+    // The properties widgets edit the object, so they get a copy of the cached state.
+    // Every instance of the object is the same object, so it is looked up by name instead of by full path.
+    // The previous copy is deleted only once no panel points to it any more. The pending preview was applied above.
+    BRLCAD::Object *previousObject = object;
+    const std::shared_ptr<const BRLCAD::Object> state = document.getObjectState(name);
+    object = state != nullptr ? state->Clone() : nullptr;
 
-    static TypeSpecificProperties * current = nullptr;
-    delete current;
-    current = new TypeSpecificProperties(document, object, objectId);
-    typeSpecificPropertiesArea->addWidget(current);
+    // panels are kept per type and rebound, so going through the tree does not create widgets
+    if (currentTypeSpecificProperties != nullptr) currentTypeSpecificProperties->hide();
+    if (object == nullptr) {
+        currentTypeSpecificProperties = nullptr;
+        delete previousObject;
+        return;
+    }
+    objectType = QString(object->Type());
+    const QString poolKey = TypeSpecificProperties::getPoolKey(object);
+    currentTypeSpecificProperties = typeSpecificPropertiesPool.value(poolKey, nullptr);
+    if (currentTypeSpecificProperties == nullptr) {
+        currentTypeSpecificProperties = new TypeSpecificProperties(document, object, objectId);
+        typeSpecificPropertiesPool[poolKey] = currentTypeSpecificProperties;
+        typeSpecificPropertiesArea->addWidget(currentTypeSpecificProperties);
+    }
+    else {
+        currentTypeSpecificProperties->bindObject(object, objectId);
+    }
+    currentTypeSpecificProperties->show();
+    delete previousObject;
 
     QString nameType = "<font color='$Color-PropertiesObjectNameText'>"+name+"</font><font color='$Color-DefaultFontColor'> ( "
                         "<font color='$Color-PropertiesObjectTypeText'>"+breakStringAtCaps(objectType)+"</font><font color='$Color-DefaultFontColor'> )";
     nameWidget->setText(Globals::theme->process(nameType));
 }
+
+void Properties::bindObjects(const QVector<int> &objectIds) {
+    document.commitPreview();
+    this->objectIds = objectIds;
+    nameWidget->hide();
+    fullPathWidget->hide();
+    typeSpecificPropertiesArea->hide();
+    bulkProperties->bindObjects(objectIds);
+    bulkProperties->show();
+}
+
+void Properties::clear() {
+    document.commitPreview();
+    objectId = -1;
+    objectIds.clear();
+    nameWidget->hide();
+    fullPathWidget->hide();
+    typeSpecificPropertiesArea->hide();
+    bulkProperties->hide();
+    if (currentTypeSpecificProperties != nullptr) currentTypeSpecificProperties->hide();
+    currentTypeSpecificProperties = nullptr;
+    delete object;
+    object = nullptr;
+}
+
+// A structural undo or redo can remove the bound objects from the tree, and their ids can be given to new objects
+void Properties::refresh() {
+    const QHash<int, int> &parents = document.getObjectTree()->getParent();
+    if (!objectIds.isEmpty()) {
+        QVector<int> remainingObjectIds;
+        for (int id : objectIds) {
+            if (parents.contains(id)) remainingObjectIds.append(id);
+        }
+        if (remainingObjectIds.isEmpty()) clear();
+        else bindObjects(remainingObjectIds);
+    }
+    else if (objectId != -1) {
+        if (parents.contains(objectId) && document.getObjectTree()->getFullPathMap().value(objectId) == fullPath) bindObject(objectId);
+        else clear();
+    }
+}
@@ -4,6 +4,7 @@
 
 
 #include <QCheckBox>
+#include <QSignalBlocker>
 #include "TypeSpecificProperties.h"
 #include "QHBoxWidget.h"
 
@@ -11,7 +12,6 @@
 #include <include/QVBoxWidget.h>
 #include <include/DataRow.h>
 #include <include/ObjectDataField.h>
-#include <include/ObjectDataTable.h>
 #include <brlcad/BagOfTriangles.h>
 #include <brlcad/EllipticalTorus.h>
 #include <brlcad/Halfspace.h>
@@ -26,501 +26,298 @@
 
 using namespace std;
 
+static const QStringList pointsIndices = {"P1", "P2", "P3", "P4", "P5", "P6", "P7", "P8"};
+static const QStringList abcdIndices = {"A", "B", "C", "D", "E", "F"};
 
+// Describes one field of a primitive of type T and creates its ObjectDataField
+template<typename T>
+struct FieldDescriptor {
+    std::function<ObjectDataFieldBase*(Document *document, T *object)> create;
+};
 
-TypeSpecificProperties::TypeSpecificProperties(Document &document, BRLCAD::Object *object, const int objectId)
-        : document(document), object(object) {
-    setObjectName("properties-TypeSpecificProperties");
-    l = getBoxLayout();
-    l->setContentsMargins(0, 0, 0, 0);
+template<typename T, typename Getter, typename Setter>
+static FieldDescriptor<T> makeField(Getter getter, Setter setter, const QString &title) {
+    return {[getter, setter, title](Document *document, T *object) -> ObjectDataFieldBase* {
+        return new ObjectDataField<T>(document, object, getter, setter, title);
+    }};
+}
 
-    const QStringList pointsIndices = {"P1", "P2", "P3", "P4", "P5", "P6", "P7", "P8"};
-    const QStringList abcdIndices = {"A", "B", "C", "D", "E", "F"};
+template<typename T, typename Setter>
+static FieldDescriptor<T> makeIndexedField(BRLCAD::Vector3D (T::*getter)(size_t) const, Setter setter, size_t start,
+        const std::function<size_t(const T &object)> &count, const QStringList &indices, const QString &title) {
+    return {[getter, setter, start, count, indices, title](Document *document, T *object) -> ObjectDataFieldBase* {
+        return new ObjectDataField<T>(document, object, getter, setter, start, object != nullptr ? count(*object) : 0, indices, title);
+    }};
+}
 
-    if(QString(object->Type()) == "Combination") {
-        BRLCAD::Combination *comb = dynamic_cast<BRLCAD::Combination*>(object);
+// The getter types pick the kind of field, as the ObjectDataField constructors do
+template<typename T, typename Setter>
+static FieldDescriptor<T> field(BRLCAD::Vector3D (T::*getter)() const, Setter setter, const QString &title) {
+    return makeField<T>(getter, setter, title);
+}
 
-        CollapsibleWidget *childrenListCollapsible = new CollapsibleWidget();
-        l->addWidget(childrenListCollapsible);
-        QVBoxWidget * childrenList = new QVBoxWidget();
-        childrenListCollapsible->setTitle("Children");
-        childrenListCollapsible->setWidget(childrenList);
+template<typename T, typename Setter>
+static FieldDescriptor<T> field(double (T::*getter)() const, Setter setter, const QString &title) {
+    return makeField<T>(getter, setter, title);
+}
 
-        for (int childId : document.getObjectTree()->getChildren()[objectId]){
-            QString childName = document.getObjectTree()->getNameMap()[childId];
-            childrenList->addWidget(new QLabel(childName));
-        }
+template<typename T, typename Setter>
+static FieldDescriptor<T> field(BRLCAD::Vector3D (T::*getter)(size_t) const, Setter setter, size_t start, size_t count,
+        const QStringList &indices, const QString &title) {
+    return makeIndexedField<T>(getter, setter, start, [count](const T &) { return count; }, indices, title);
+}
 
-        QCheckBox *hasColorCheck = new QCheckBox();
-        QHBoxWidget * colorHolder = new QHBoxWidget(this,hasColorCheck);
-        l->addWidget(colorHolder);
-        colorHolder->setStyleSheet("margin-top:11px;");
-        hasColorCheck->setText("Has Color");
-        hasColorCheck->setCheckState(comb->HasColor() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
-        connect(hasColorCheck,&QCheckBox::stateChanged,[this,objectId](int newState){
-            getBRLCADObject(this->document.getDatabase(),this->document.getObjectTree()->getFullPathMap()[objectId],[newState](BRLCAD::Object &object){
-                if(newState == Qt::CheckState::Checked){
-                    dynamic_cast<BRLCAD::Combination&>(object).SetHasColor(true);
-                }
-                else {
-                    dynamic_cast<BRLCAD::Combination&>(object).SetHasColor(false);
-                }
-            });
-        });
+// The number of values is read from the object, ex: the vertices of an Arb8
+template<typename T, typename Setter>
+static FieldDescriptor<T> field(BRLCAD::Vector3D (T::*getter)(size_t) const, Setter setter, size_t start,
+        size_t (T::*count)() const, const QStringList &indices, const QString &title) {
+    return makeIndexedField<T>(getter, setter, start, [count](const T &object) { return (object.*count)(); }, indices, title);
+}
 
-        colorHolder->getBoxLayout()->addStretch();
-
-        QPushButton *colorButton = new QPushButton();
-        colorButton->setObjectName("colorButton");
-        colorButton->setStyleSheet("background-color:"+document.getObjectTree()->getColorMap()[objectId].toHexString());
-        colorHolder->addWidget(colorButton);
-        /*connect(colorButton, &QPushButton::clicked, this, [this,objectId](){
-            const QColor &initial = this->document.getObjectTree()->getColorMap()[objectId].toQColor();
-            QColor selectedColor = QColorDialog::getColor(initial);
-
-            getBRLCADObject(this->document.getDatabase(),this->document.getObjectTree()->getFullPathMap()[objectId],[this,selectedColor](BRLCAD::Object &object){
-                BRLCAD::Combination editableComb =  dynamic_cast<BRLCAD::Combination&>(object);
-                editableComb.SetRed(selectedColor.redF());
-                editableComb.SetGreen(selectedColor.greenF());
-                editableComb.SetBlue(selectedColor.blueF());
-                cout<<selectedColor.redF()<<" "<<selectedColor.greenF()<<" "<<selectedColor.blueF()<<endl;
-                this->document.getDatabase()->Set(editableComb);
-            });
-            this->document.getObjectTree()->buildColorMap(objectId);
-            this->document.modifyObjectNoSet(objectId);
-            this->document.getDisplayGrid()->forceRerenderAllDisplays();
-        });*/
-    }
+// The fields of each primitive type, in the order they are shown
+template<typename T>
+static QVector<FieldDescriptor<T>> fieldDescriptors();
 
-    if(QString(object->Type()) == "Arb8") {
-        ObjectDataField<BRLCAD::Arb8> * property;
-        property = new ObjectDataField<BRLCAD::Arb8>(
-                &document,
-                object,
-                &BRLCAD::Arb8::Point,
-                &BRLCAD::Arb8::SetPoint,
-                1,
-                dynamic_cast<BRLCAD::Arb8*>(object)->NumberOfVertices(),
-                pointsIndices,
-                "Points");
-        l->addWidget(property);
-    }
+template<>
+QVector<FieldDescriptor<BRLCAD::Arb8>> fieldDescriptors<BRLCAD::Arb8>() {
+    return {
+            field<BRLCAD::Arb8>(&BRLCAD::Arb8::Point, &BRLCAD::Arb8::SetPoint, 1, &BRLCAD::Arb8::NumberOfVertices, pointsIndices, "Points")
+    };
+}
 
+template<>
+QVector<FieldDescriptor<BRLCAD::Cone>> fieldDescriptors<BRLCAD::Cone>() {
+    return {
+            field<BRLCAD::Cone>(&BRLCAD::Cone::BasePoint, &BRLCAD::Cone::SetBasePoint, "Base Point"),
+            field<BRLCAD::Cone>(&BRLCAD::Cone::Height, &BRLCAD::Cone::SetHeight, "Height"),
+            field<BRLCAD::Cone>(&BRLCAD::Cone::SemiPrincipalAxis, &BRLCAD::Cone::SetSemiPrincipalAxis, 0, 3, abcdIndices, "Semi Principal Axes")
+    };
+}
 
-    if(QString(object->Type()) == "Cone") {
-        ObjectDataField<BRLCAD::Cone> * property;
-
-        property = new ObjectDataField<BRLCAD::Cone>(
-                &document,
-                object,
-                &BRLCAD::Cone::BasePoint,
-                &BRLCAD::Cone::SetBasePoint,
-                "Base Point");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Cone>(
-                &document,
-                object,
-                &BRLCAD::Cone::Height,
-                &BRLCAD::Cone::SetHeight,
-                "Height");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Cone>(
-                &document,
-                object,
-                &BRLCAD::Cone::SemiPrincipalAxis,
-                &BRLCAD::Cone::SetSemiPrincipalAxis,
-                0,
-                3,
-                abcdIndices,
-                "Semi Principal Axes");
-        l->addWidget(property);
-    }
+template<>
+QVector<FieldDescriptor<BRLCAD::Ellipsoid>> fieldDescriptors<BRLCAD::Ellipsoid>() {
+    return {
+            field<BRLCAD::Ellipsoid>(&BRLCAD::Ellipsoid::Center, &BRLCAD::Ellipsoid::SetCenter, "Center"),
+            field<BRLCAD::Ellipsoid>(&BRLCAD::Ellipsoid::SemiPrincipalAxis, &BRLCAD::Ellipsoid::SetSemiPrincipalAxis, 0, 3, abcdIndices, "Semi Principal Axes")
+    };
+}
 
+template<>
+QVector<FieldDescriptor<BRLCAD::EllipticalTorus>> fieldDescriptors<BRLCAD::EllipticalTorus>() {
+    return {
+            field<BRLCAD::EllipticalTorus>(&BRLCAD::EllipticalTorus::Center, &BRLCAD::EllipticalTorus::SetCenter, "Center"),
+            field<BRLCAD::EllipticalTorus>(&BRLCAD::EllipticalTorus::Normal, &BRLCAD::EllipticalTorus::SetNormal, "Normal"),
+            field<BRLCAD::EllipticalTorus>(&BRLCAD::EllipticalTorus::TubeCenterLineRadius, &BRLCAD::EllipticalTorus::SetTubeCenterLineRadius, "Tube Center Line Radius"),
+            field<BRLCAD::EllipticalTorus>(&BRLCAD::EllipticalTorus::TubeSemiMajorAxis, &BRLCAD::EllipticalTorus::SetTubeSemiMajorAxis, "Tube Semi Major Axes"),
+            field<BRLCAD::EllipticalTorus>(&BRLCAD::EllipticalTorus::TubeSemiMinorAxis, &BRLCAD::EllipticalTorus::SetTubeSemiMinorAxis, "Tube Semi Minor Axes")
+    };
+}
 
-    if(QString(object->Type()) == "Ellipsoid") {
-        ObjectDataField<BRLCAD::Ellipsoid> * property;
-
-        property = new ObjectDataField<BRLCAD::Ellipsoid>(
-                &document,
-                object,
-                &BRLCAD::Ellipsoid::Center,
-                &BRLCAD::Ellipsoid::SetCenter,
-                "Center");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Ellipsoid>(
-                &document,
-                object,
-                &BRLCAD::Ellipsoid::SemiPrincipalAxis,
-                &BRLCAD::Ellipsoid::SetSemiPrincipalAxis,
-                0,
-                3,
-                abcdIndices,
-                "Semi Principal Axes");
-        l->addWidget(property);
-    }
+template<>
+QVector<FieldDescriptor<BRLCAD::Halfspace>> fieldDescriptors<BRLCAD::Halfspace>() {
+    return {
+            field<BRLCAD::Halfspace>(&BRLCAD::Halfspace::Normal, &BRLCAD::Halfspace::SetNormal, "Normal"),
+            field<BRLCAD::Halfspace>(&BRLCAD::Halfspace::DistanceFromOrigin, &BRLCAD::Halfspace::SetDistanceFromOrigin, "Distance From Origin")
+    };
+}
 
+template<>
+QVector<FieldDescriptor<BRLCAD::HyperbolicCylinder>> fieldDescriptors<BRLCAD::HyperbolicCylinder>() {
+    return {
+            field<BRLCAD::HyperbolicCylinder>(&BRLCAD::HyperbolicCylinder::BasePoint, &BRLCAD::HyperbolicCylinder::SetBasePoint, "Base Point"),
+            field<BRLCAD::HyperbolicCylinder>(&BRLCAD::HyperbolicCylinder::Height, &BRLCAD::HyperbolicCylinder::SetHeight, "Height"),
+            field<BRLCAD::HyperbolicCylinder>(&BRLCAD::HyperbolicCylinder::Depth, &BRLCAD::HyperbolicCylinder::SetDepth, "Depth"),
+            field<BRLCAD::HyperbolicCylinder>(&BRLCAD::HyperbolicCylinder::HalfWidth, &BRLCAD::HyperbolicCylinder::SetHalfWidth, "Half Width"),
+            field<BRLCAD::HyperbolicCylinder>(&BRLCAD::HyperbolicCylinder::ApexAsymptoteDistance, &BRLCAD::HyperbolicCylinder::SetApexAsymptoteDistance, "Apex Asymptote Distance")
+    };
+}
 
-    if(QString(object->Type()) == "EllipticalTorus") {
-        ObjectDataField<BRLCAD::EllipticalTorus> * property;
-
-        property = new ObjectDataField<BRLCAD::EllipticalTorus>(
-                &document,
-                object,
-                &BRLCAD::EllipticalTorus::Center,
-                &BRLCAD::EllipticalTorus::SetCenter,
-                "Center");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::EllipticalTorus>(
-                &document,
-                object,
-                &BRLCAD::EllipticalTorus::Normal,
-                &BRLCAD::EllipticalTorus::SetNormal,
-                "Normal");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::EllipticalTorus>(
-                &document,
-                object,
-                &BRLCAD::EllipticalTorus::TubeCenterLineRadius,
-                &BRLCAD::EllipticalTorus::SetTubeCenterLineRadius,
-                "Tube Center Line Radius");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::EllipticalTorus>(
-                &document,
-                object,
-                &BRLCAD::EllipticalTorus::TubeSemiMajorAxis,
-                &BRLCAD::EllipticalTorus::SetTubeSemiMajorAxis,
-                "Tube Semi Major Axes");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::EllipticalTorus>(
-                &document,
-                object,
-                &BRLCAD::EllipticalTorus::TubeSemiMinorAxis,
-                &BRLCAD::EllipticalTorus::SetTubeSemiMinorAxis,
-                "Tube Semi Minor Axes");
-        l->addWidget(property);
+template<>
+QVector<FieldDescriptor<BRLCAD::Hyperboloid>> fieldDescriptors<BRLCAD::Hyperboloid>() {
+    return {
+            field<BRLCAD::Hyperboloid>(&BRLCAD::Hyperboloid::BasePoint, &BRLCAD::Hyperboloid::SetBasePoint, "Base Point"),
+            field<BRLCAD::Hyperboloid>(&BRLCAD::Hyperboloid::Height, &BRLCAD::Hyperboloid::SetHeight, "Height"),
+            field<BRLCAD::Hyperboloid>(&BRLCAD::Hyperboloid::SemiMajorAxis, &BRLCAD::Hyperboloid::SetSemiMajorAxis, "Semi Major Axis"),
+            field<BRLCAD::Hyperboloid>(&BRLCAD::Hyperboloid::SemiMajorAxisDirection, &BRLCAD::Hyperboloid::SetSemiMajorAxisDirection, "Semi Major Axis Direction"),
+            field<BRLCAD::Hyperboloid>(&BRLCAD::Hyperboloid::SemiMajorAxisLength, &BRLCAD::Hyperboloid::SetSemiMajorAxisLength, "Semi Major Axis Length"),
+            field<BRLCAD::Hyperboloid>(&BRLCAD::Hyperboloid::SemiMinorAxisLength, &BRLCAD::Hyperboloid::SetSemiMinorAxisLength, "Semi Minor Axis Length"),
+            field<BRLCAD::Hyperboloid>(&BRLCAD::Hyperboloid::ApexAsymptoteDistance, &BRLCAD::Hyperboloid::SetApexAsymptoteDistance, "Apex Asymptote Distance")
+    };
+}
 
-    }
+template<>
+QVector<FieldDescriptor<BRLCAD::ParabolicCylinder>> fieldDescriptors<BRLCAD::ParabolicCylinder>() {
+    return {
+            field<BRLCAD::ParabolicCylinder>(&BRLCAD::ParabolicCylinder::BasePoint, &BRLCAD::ParabolicCylinder::SetBasePoint, "Base Point"),
+            field<BRLCAD::ParabolicCylinder>(&BRLCAD::ParabolicCylinder::Height, &BRLCAD::ParabolicCylinder::SetHeight, "Height"),
+            field<BRLCAD::ParabolicCylinder>(&BRLCAD::ParabolicCylinder::Depth, &BRLCAD::ParabolicCylinder::SetDepth, "Depth"),
+            field<BRLCAD::ParabolicCylinder>(&BRLCAD::ParabolicCylinder::HalfWidth, &BRLCAD::ParabolicCylinder::SetHalfWidth, "Half Width")
+    };
+}
 
+template<>
+QVector<FieldDescriptor<BRLCAD::Paraboloid>> fieldDescriptors<BRLCAD::Paraboloid>() {
+    return {
+            field<BRLCAD::Paraboloid>(&BRLCAD::Paraboloid::BasePoint, &BRLCAD::Paraboloid::SetBasePoint, "Base Point"),
+            field<BRLCAD::Paraboloid>(&BRLCAD::Paraboloid::Height, &BRLCAD::Paraboloid::SetHeight, "Height"),
+            field<BRLCAD::Paraboloid>(&BRLCAD::Paraboloid::SemiMajorAxis, &BRLCAD::Paraboloid::SetSemiMajorAxis, "Semi Major Axis"),
+            field<BRLCAD::Paraboloid>(&BRLCAD::Paraboloid::SemiMajorAxisDirection, &BRLCAD::Paraboloid::SetSemiMajorAxisDirection, "Semi Major Axis Direction"),
+            field<BRLCAD::Paraboloid>(&BRLCAD::Paraboloid::SemiMajorAxisLength, &BRLCAD::Paraboloid::SetSemiMajorAxisLength, "Semi Major Axis Length"),
+            field<BRLCAD::Paraboloid>(&BRLCAD::Paraboloid::SemiMinorAxisLength, &BRLCAD::Paraboloid::SetSemiMinorAxisLength, "Semi Minor Axis Length")
+    };
+}
 
-    if(QString(object->Type()) == "Halfspace") {
-        ObjectDataField<BRLCAD::Halfspace> * property;
+template<>
+QVector<FieldDescriptor<BRLCAD::Particle>> fieldDescriptors<BRLCAD::Particle>() {
+    return {
+            field<BRLCAD::Particle>(&BRLCAD::Particle::BasePoint, &BRLCAD::Particle::SetBasePoint, "Base Point"),
+            field<BRLCAD::Particle>(&BRLCAD::Particle::Height, &BRLCAD::Particle::SetHeight, "Height"),
+            field<BRLCAD::Particle>(&BRLCAD::Particle::BaseRadius, &BRLCAD::Particle::SetBaseRadius, "Base Radius"),
+            field<BRLCAD::Particle>(&BRLCAD::Particle::TopRadius, &BRLCAD::Particle::SetTopRadius, "Top Radius")
+    };
+}
 
-        property = new ObjectDataField<BRLCAD::Halfspace>(
-                &document,
-                object,
-                &BRLCAD::Halfspace::Normal,
-                &BRLCAD::Halfspace::SetNormal,
-                "Normal");
-        l->addWidget(property);
+template<>
+QVector<FieldDescriptor<BRLCAD::Sphere>> fieldDescriptors<BRLCAD::Sphere>() {
+    return {
+            field<BRLCAD::Sphere>(&BRLCAD::Sphere::Center, &BRLCAD::Sphere::SetCenter, "Center"),
+            field<BRLCAD::Sphere>(&BRLCAD::Sphere::Radius, &BRLCAD::Sphere::SetRadius, "Radius")
+    };
+}
 
-        property = new ObjectDataField<BRLCAD::Halfspace>(
-                &document,
-                object,
-                &BRLCAD::Halfspace::DistanceFromOrigin,
-                &BRLCAD::Halfspace::SetDistanceFromOrigin,
-                "Distance From Origin");
-        l->addWidget(property);
+template<>
+QVector<FieldDescriptor<BRLCAD::Torus>> fieldDescriptors<BRLCAD::Torus>() {
+    return {
+            field<BRLCAD::Torus>(&BRLCAD::Torus::Center, &BRLCAD::Torus::SetCenter, "Center"),
+            field<BRLCAD::Torus>(&BRLCAD::Torus::Normal, &BRLCAD::Torus::SetNormal, "Normal"),
+            field<BRLCAD::Torus>(&BRLCAD::Torus::TubeCenterLineRadius, &BRLCAD::Torus::SetTubeCenterLineRadius, "Tube Center Line Radius"),
+            field<BRLCAD::Torus>(&BRLCAD::Torus::TubeRadius, &BRLCAD::Torus::SetTubeRadius, "Tube TubeRadius")
+    };
+}
 
+// Adds the fields of the primitive type T to panel. The descriptors are made once per type.
+template<typename T>
+static void addFields(TypeSpecificProperties &panel) {
+    static const QVector<FieldDescriptor<T>> descriptors = fieldDescriptors<T>();
+    T *object = dynamic_cast<T*>(panel.getObject());
+    for (const FieldDescriptor<T> &descriptor : descriptors) {
+        panel.addField(descriptor.create(&panel.getDocument(), object));
     }
+}
 
+// Field builders by type tag. ClassName() is what Type() returns for objects of that class.
+typedef void (*FieldsBuilder)(TypeSpecificProperties &panel);
+static const QHash<QString, FieldsBuilder> fieldsBuilders = {
+        {BRLCAD::Arb8::ClassName(), addFields<BRLCAD::Arb8>},
+        {BRLCAD::Cone::ClassName(), addFields<BRLCAD::Cone>},
+        {BRLCAD::Ellipsoid::ClassName(), addFields<BRLCAD::Ellipsoid>},
+        {BRLCAD::EllipticalTorus::ClassName(), addFields<BRLCAD::EllipticalTorus>},
+        {BRLCAD::Halfspace::ClassName(), addFields<BRLCAD::Halfspace>},
+        {BRLCAD::HyperbolicCylinder::ClassName(), addFields<BRLCAD::HyperbolicCylinder>},
+        {BRLCAD::Hyperboloid::ClassName(), addFields<BRLCAD::Hyperboloid>},
+        {BRLCAD::ParabolicCylinder::ClassName(), addFields<BRLCAD::ParabolicCylinder>},
+        {BRLCAD::Paraboloid::ClassName(), addFields<BRLCAD::Paraboloid>},
+        {BRLCAD::Particle::ClassName(), addFields<BRLCAD::Particle>},
+        {BRLCAD::Sphere::ClassName(), addFields<BRLCAD::Sphere>},
+        {BRLCAD::Torus::ClassName(), addFields<BRLCAD::Torus>}
+};
 
-    if(QString(object->Type()) == "HyperbolicCylinder") {
-        ObjectDataField<BRLCAD::HyperbolicCylinder> * property;
-
-        property = new ObjectDataField<BRLCAD::HyperbolicCylinder>(
-                &document,
-                object,
-                &BRLCAD::HyperbolicCylinder::BasePoint,
-                &BRLCAD::HyperbolicCylinder::SetBasePoint,
-                "Base Point");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::HyperbolicCylinder>(
-                &document,
-                object,
-                &BRLCAD::HyperbolicCylinder::Height,
-                &BRLCAD::HyperbolicCylinder::SetHeight,
-                "Height");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::HyperbolicCylinder>(
-                &document,
-                object,
-                &BRLCAD::HyperbolicCylinder::Depth,
-                &BRLCAD::HyperbolicCylinder::SetDepth,
-                "Depth");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::HyperbolicCylinder>(
-                &document,
-                object,
-                &BRLCAD::HyperbolicCylinder::HalfWidth,
-                &BRLCAD::HyperbolicCylinder::SetHalfWidth,
-                "Half Width");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::HyperbolicCylinder>(
-                &document,
-                object,
-                &BRLCAD::HyperbolicCylinder::ApexAsymptoteDistance,
-                &BRLCAD::HyperbolicCylinder::SetApexAsymptoteDistance,
-                "Apex Asymptote Distance");
-        l->addWidget(property);
-    }
 
+TypeSpecificProperties::TypeSpecificProperties(Document &document, BRLCAD::Object *object, const int objectId)
+        : document(document), object(object) {
+    setObjectName("properties-TypeSpecificProperties");
+    l = getBoxLayout();
+    l->setContentsMargins(0, 0, 0, 0);
 
-    if(QString(object->Type()) == "Hyperboloid") {
-        ObjectDataField<BRLCAD::Hyperboloid> * property;
-
-        property = new ObjectDataField<BRLCAD::Hyperboloid>(
-                &document,
-                object,
-                &BRLCAD::Hyperboloid::BasePoint,
-                &BRLCAD::Hyperboloid::SetBasePoint,
-                "Base Point");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Hyperboloid>(
-                &document,
-                object,
-                &BRLCAD::Hyperboloid::Height,
-                &BRLCAD::Hyperboloid::SetHeight,
-                "Height");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Hyperboloid>(
-                &document,
-                object,
-                &BRLCAD::Hyperboloid::SemiMajorAxis,
-                &BRLCAD::Hyperboloid::SetSemiMajorAxis,
-                "Semi Major Axis");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Hyperboloid>(
-                &document,
-                object,
-                &BRLCAD::Hyperboloid::SemiMajorAxisDirection,
-                &BRLCAD::Hyperboloid::SetSemiMajorAxisDirection,
-                "Semi Major Axis Direction");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Hyperboloid>(
-                &document,
-                object,
-                &BRLCAD::Hyperboloid::SemiMajorAxisLength,
-                &BRLCAD::Hyperboloid::SetSemiMajorAxisLength,
-                "Semi Major Axis Length");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Hyperboloid>(
-                &document,
-                object,
-                &BRLCAD::Hyperboloid::SemiMinorAxisLength,
-                &BRLCAD::Hyperboloid::SetSemiMinorAxisLength,
-                "Semi Minor Axis Length");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Hyperboloid>(
-                &document,
-                object,
-                &BRLCAD::Hyperboloid::ApexAsymptoteDistance,
-                &BRLCAD::Hyperboloid::SetApexAsymptoteDistance,
-                "Apex Asymptote Distance");
-        l->addWidget(property);
+    const QString type = object->Type();
+    if (type == BRLCAD::Combination::ClassName()) {
+        addCombinationFields();
     }
-
-
-    if(QString(object->Type()) == "ParabolicCylinder") {
-        ObjectDataField<BRLCAD::ParabolicCylinder> * property;
-
-        property = new ObjectDataField<BRLCAD::ParabolicCylinder>(
-                &document,
-                object,
-                &BRLCAD::ParabolicCylinder::BasePoint,
-                &BRLCAD::ParabolicCylinder::SetBasePoint,
-                "Base Point");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::ParabolicCylinder>(
-                &document,
-                object,
-                &BRLCAD::ParabolicCylinder::Height,
-                &BRLCAD::ParabolicCylinder::SetHeight,
-                "Height");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::ParabolicCylinder>(
-                &document,
-                object,
-                &BRLCAD::ParabolicCylinder::Depth,
-                &BRLCAD::ParabolicCylinder::SetDepth,
-                "Depth");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::ParabolicCylinder>(
-                &document,
-                object,
-                &BRLCAD::ParabolicCylinder::HalfWidth,
-                &BRLCAD::ParabolicCylinder::SetHalfWidth,
-                "Half Width");
-        l->addWidget(property);
+    else {
+        const QHash<QString, FieldsBuilder>::const_iterator builder = fieldsBuilders.find(type);
+        if (builder != fieldsBuilders.end()) (*builder)(*this);
     }
 
+    l->addStretch(1);
+    bindObject(object, objectId);
+}
 
-    if(QString(object->Type()) == "Paraboloid") {
-        ObjectDataField<BRLCAD::Paraboloid> * property;
-
-        property = new ObjectDataField<BRLCAD::Paraboloid>(
-                &document,
-                object,
-                &BRLCAD::Paraboloid::BasePoint,
-                &BRLCAD::Paraboloid::SetBasePoint,
-                "Base Point");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Paraboloid>(
-                &document,
-                object,
-                &BRLCAD::Paraboloid::Height,
-                &BRLCAD::Paraboloid::SetHeight,
-                "Height");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Paraboloid>(
-                &document,
-                object,
-                &BRLCAD::Paraboloid::SemiMajorAxis,
-                &BRLCAD::Paraboloid::SetSemiMajorAxis,
-                "Semi Major Axis");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Paraboloid>(
-                &document,
-                object,
-                &BRLCAD::Paraboloid::SemiMajorAxisDirection,
-                &BRLCAD::Paraboloid::SetSemiMajorAxisDirection,
-                "Semi Major Axis Direction");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Paraboloid>(
-                &document,
-                object,
-                &BRLCAD::Paraboloid::SemiMajorAxisLength,
-                &BRLCAD::Paraboloid::SetSemiMajorAxisLength,
-                "Semi Major Axis Length");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Paraboloid>(
-                &document,
-                object,
-                &BRLCAD::Paraboloid::SemiMinorAxisLength,
-                &BRLCAD::Paraboloid::SetSemiMinorAxisLength,
-                "Semi Minor Axis Length");
-        l->addWidget(property);
-    }
+QString TypeSpecificProperties::getPoolKey(const BRLCAD::Object *object) {
+    const QString type = object->Type();
+    if (type == BRLCAD::Arb8::ClassName()) return type + QString::number(dynamic_cast<const BRLCAD::Arb8*>(object)->NumberOfVertices());
+    return type;
+}
 
+void TypeSpecificProperties::addField(ObjectDataFieldBase *field) {
+    fields.append(field);
+    l->addWidget(field);
+}
 
-    if(QString(object->Type()) == "Particle") {
-        ObjectDataField<BRLCAD::Particle> * property;
-
-        property = new ObjectDataField<BRLCAD::Particle>(
-                &document,
-                object,
-                &BRLCAD::Particle::BasePoint,
-                &BRLCAD::Particle::SetBasePoint,
-                "Base Point");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Particle>(
-                &document,
-                object,
-                &BRLCAD::Particle::Height,
-                &BRLCAD::Particle::SetHeight,
-                "Height");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Particle>(
-                &document,
-                object,
-                &BRLCAD::Particle::BaseRadius,
-                &BRLCAD::Particle::SetBaseRadius,
-                "Base Radius");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Particle>(
-                &document,
-                object,
-                &BRLCAD::Particle::TopRadius,
-                &BRLCAD::Particle::SetTopRadius,
-                "Top Radius");
-        l->addWidget(property);
+void TypeSpecificProperties::bindObject(BRLCAD::Object *object, const int objectId) {
+    this->object = object;
+    for (ObjectDataFieldBase *field : fields) {
+        field->bindObject(object);
     }
+    if (childrenList == nullptr) return;
 
-
-    if(QString(object->Type()) == "Sphere") {
-        ObjectDataField<BRLCAD::Sphere> * property;
-
-        property = new ObjectDataField<BRLCAD::Sphere>(
-                &document,
-                object,
-                &BRLCAD::Sphere::Center,
-                &BRLCAD::Sphere::SetCenter,
-                "Center");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Sphere>(
-                &document,
-                object,
-                &BRLCAD::Sphere::Radius,
-                &BRLCAD::Sphere::SetRadius,
-                "Radius");
-        l->addWidget(property);
+    BRLCAD::Combination *comb = dynamic_cast<BRLCAD::Combination*>(object);
+    const QVector<int> &children = document.getObjectTree()->getChildren()[objectId];
+    while (childLabels.size() < children.size()) {
+        childLabels.append(new QLabel());
+        childrenList->addWidget(childLabels.last());
     }
-
-
-    if(QString(object->Type()) == "Torus") {
-        ObjectDataField<BRLCAD::Torus> * property;
-
-        property = new ObjectDataField<BRLCAD::Torus>(
-                &document,
-                object,
-                &BRLCAD::Torus::Center,
-                &BRLCAD::Torus::SetCenter,
-                "Center");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Torus>(
-                &document,
-                object,
-                &BRLCAD::Torus::Normal,
-                &BRLCAD::Torus::SetNormal,
-                "Normal");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Torus>(
-                &document,
-                object,
-                &BRLCAD::Torus::TubeCenterLineRadius,
-                &BRLCAD::Torus::SetTubeCenterLineRadius,
-                "Tube Center Line Radius");
-        l->addWidget(property);
-
-        property = new ObjectDataField<BRLCAD::Torus>(
-                &document,
-                object,
-                &BRLCAD::Torus::TubeRadius,
-                &BRLCAD::Torus::SetTubeRadius,
-                "Tube TubeRadius");
-        l->addWidget(property);
+    for (int i = 0; i < childLabels.size(); i++) {
+        if (i < children.size()) childLabels[i]->setText(document.getObjectTree()->getNameMap()[children[i]]);
+        childLabels[i]->setVisible(i < children.size());
     }
 
-    l->addStretch(1);
+    const QSignalBlocker blocker(hasColorCheck);
+    hasColorCheck->setCheckState(comb->HasColor() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
+    colorButton->setStyleSheet("background-color:"+document.getObjectTree()->getColorMap()[objectId].toHexString());
 }
 
+void TypeSpecificProperties::addCombinationFields() {
+    CollapsibleWidget *childrenListCollapsible = new CollapsibleWidget();
+    l->addWidget(childrenListCollapsible);
+    childrenList = new QVBoxWidget();
+    childrenListCollapsible->setTitle("Children");
+    childrenListCollapsible->setWidget(childrenList);
+
+    hasColorCheck = new QCheckBox();
+    QHBoxWidget * colorHolder = new QHBoxWidget(this,hasColorCheck);
+    l->addWidget(colorHolder);
+    colorHolder->setStyleSheet("margin-top:11px;");
+    hasColorCheck->setText("Has Color");
+    connect(hasColorCheck,&QCheckBox::stateChanged,[this](int newState){
+        BRLCAD::Combination *comb = dynamic_cast<BRLCAD::Combination*>(this->object);
+        if(newState == Qt::CheckState::Checked){
+            comb->SetHasColor(true);
+        }
+        else {
+            comb->SetHasColor(false);
+        }
+        this->document.modifyObject(comb);
+    });
+
+    colorHolder->getBoxLayout()->addStretch();
+
+    colorButton = new QPushButton();
+    colorButton->setObjectName("colorButton");
+    colorHolder->addWidget(colorButton);
+    /*connect(colorButton, &QPushButton::clicked, this, [this,objectId](){
+        const QColor &initial = this->document.getObjectTree()->getColorMap()[objectId].toQColor();
+        QColor selectedColor = QColorDialog::getColor(initial);
+
+        getBRLCADObject(this->document.getWritableDatabase(),this->document.getObjectTree()->getFullPathMap()[objectId],[this,selectedColor](BRLCAD::Object &object){
+            BRLCAD::Combination editableComb =  dynamic_cast<BRLCAD::Combination&>(object);
+            editableComb.SetRed(selectedColor.redF());
+            editableComb.SetGreen(selectedColor.greenF());
+            editableComb.SetBlue(selectedColor.blueF());
+            cout<<selectedColor.redF()<<" "<<selectedColor.greenF()<<" "<<selectedColor.blueF()<<endl;
+            this->document.getWritableDatabase()->Set(editableComb);
+        });
+        this->document.getObjectTree()->buildColorMap(objectId);
+        this->document.modifyObjectNoSet(objectId);
+        this->document.getDisplayGrid()->forceRerenderAllDisplays();
+    });*/
+}
@@ -1,6 +1,7 @@
 //#define ARB_DEBUG
 
 #include <QtWidgets/QApplication>
+#include <QSurfaceFormat>
 #include <DisplayGrid.h>
 #include "MainWindow.h"
 
@@ -14,6 +15,16 @@ int main(int argc, char*argv[]) {
 #endif
 
 
+    // OpenGL 3.3 for the shaders of DisplayManager. The compatibility profile keeps the fixed function pipeline,
+    // which is still used for display lists when the shaders are not available.
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CompatibilityProfile);
+    format.setDepthBufferSize(24);
+    QSurfaceFormat::setDefaultFormat(format);
+    // the vertex buffers of DisplayManager are shared by all displays
+    QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+
     QApplication app(argc,argv);
     MainWindow mainWindow;
     mainWindow.showMaximized();
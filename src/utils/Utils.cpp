@@ -85,6 +85,32 @@ const double * getLeafMatrix(BRLCAD::Combination::TreeNode& node, const QString&
     return nullptr;
 }
 
+const double * getLeafMatrix(const BRLCAD::Combination::ConstTreeNode& node, const QString& name) {
+    switch (node.Operation())
+    {
+        case BRLCAD::Combination::ConstTreeNode::Union:
+        case BRLCAD::Combination::ConstTreeNode::Intersection:
+        case BRLCAD::Combination::ConstTreeNode::Subtraction:
+        case BRLCAD::Combination::ConstTreeNode::ExclusiveOr: {
+            const double * resultLeft = getLeafMatrix(node.LeftOperand(), name);
+            if (resultLeft) return resultLeft;
+            return getLeafMatrix(node.RightOperand(), name);
+        }
+
+        case BRLCAD::Combination::ConstTreeNode::Not:
+            return getLeafMatrix(node.Operand(), name);
+
+        case BRLCAD::Combination::ConstTreeNode::Leaf:
+            if (QString(node.Name()) == name) return node.Matrix();
+            return nullptr;
+
+        case BRLCAD::Combination::ConstTreeNode::Null:
+            return nullptr;
+    }
+
+    return nullptr;
+}
+
 void setLeafMatrix(BRLCAD::Combination::TreeNode& node, const QString& name, double * matrix) {
     switch (node.Operation())
     {
@@ -116,6 +142,42 @@ void setLeafMatrix(BRLCAD::Combination::TreeNode& node, const QString& name, dou
     }
 }
 
+QMatrix4x4 toQMatrix4x4(const double * matrix) {
+    return QMatrix4x4(matrix[0], matrix[1], matrix[2], matrix[3], matrix[4], matrix[5], matrix[6], matrix[7],
+                      matrix[8], matrix[9], matrix[10], matrix[11], matrix[12], matrix[13], matrix[14], matrix[15]);
+}
+
+bool findLeaf(BRLCAD::Combination::TreeNode& node, const QString& name, BRLCAD::Combination::TreeNode& leaf) {
+    switch (node.Operation())
+    {
+        case BRLCAD::Combination::ConstTreeNode::Union:
+        case BRLCAD::Combination::ConstTreeNode::Intersection:
+        case BRLCAD::Combination::ConstTreeNode::Subtraction:
+        case BRLCAD::Combination::ConstTreeNode::ExclusiveOr: {
+            BRLCAD::Combination::TreeNode left = node.LeftOperand();
+            BRLCAD::Combination::TreeNode right = node.RightOperand();
+            return findLeaf(left, name, leaf) || findLeaf(right, name, leaf);
+        }
+
+        case BRLCAD::Combination::ConstTreeNode::Not: {
+            BRLCAD::Combination::TreeNode op = node.RightOperand();
+            return findLeaf(op, name, leaf);
+        }
+
+        case BRLCAD::Combination::ConstTreeNode::Leaf: {
+            if (QString(node.Name()) != name) return false;
+            leaf = node;
+            return true;
+        }
+
+        case BRLCAD::Combination::ConstTreeNode::Null: {
+            return false;
+        }
+    }
+
+    return false;
+}
+
 QImage coloredIcon(QString path, QString colorKey){
     QColor color;
     if (colorKey == ""){